@@ -160,7 +160,8 @@ class AccountUpdateCircuit : public BaseTransactionCircuit
             state.constants,
             publicKeyX,
             publicKeyY,
-            FMT(this->annotation_prefix, ".compressPublicKey")),
+            FMT(this->annotation_prefix, ".compressPublicKey"),
+            state.publicKeyRoots),
 
           // Balances
           balanceS_A(pb, state.accountA.balanceS, FMT(prefix, ".balanceS_A")),
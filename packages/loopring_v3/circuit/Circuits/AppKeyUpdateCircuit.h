@@ -116,7 +116,8 @@ class AppKeyUpdateCircuit : public BaseTransactionCircuit
             state.constants,
             appKeyPublicKeyX,
             appKeyPublicKeyY,
-            FMT(this->annotation_prefix, ".compressPublicKey")),
+            FMT(this->annotation_prefix, ".compressPublicKey"),
+            state.publicKeyRoots),
 
           // Balances
           balanceS_A(pb, state.accountA.balanceS, FMT(prefix, ".balanceS_A")),
@@ -186,6 +186,8 @@ struct TransactionAccountBalancesState : public GadgetT
     }
 };
 
+class PublicKeyRoots;
+
 struct TransactionState : public GadgetT
 {
     const jubjub::Params &params;
@@ -198,6 +200,9 @@ struct TransactionState : public GadgetT
     const VariableT &numConditionalTransactions;
     const VariableT &type;
 
+    // Public key decompression values resolved for the whole block (optional)
+    const PublicKeyRoots *publicKeyRoots;
+
     TransactionAccountState accountA;
     TransactionAccountState accountB;
     TransactionBatchAccountState accountC;
@@ -215,7 +220,8 @@ struct TransactionState : public GadgetT
       const VariableT &_protocolFeeBips,
       const VariableT &_numConditionalTransactions,
       const VariableT &_type,
-      const std::string &prefix)
+      const std::string &prefix,
+      const PublicKeyRoots *_publicKeyRoots = nullptr)
         : GadgetT(pb, prefix),
 
           params(_params),
@@ -228,6 +234,8 @@ struct TransactionState : public GadgetT
           numConditionalTransactions(_numConditionalTransactions),
           type(_type),
 
+          publicKeyRoots(_publicKeyRoots),
+
           accountA(pb, ORDER_SIZE_USER_A - 1, FMT(prefix, ".accountA")),
           accountB(pb, ORDER_SIZE_USER_B - 1, FMT(prefix, ".accountB")),
           accountC(pb, ORDER_SIZE_USER_C, FMT(prefix, ".accountC")),
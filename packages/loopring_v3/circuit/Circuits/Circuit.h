@@ -4,8 +4,11 @@
 #define _CIRCUIT_H_
 
 #include "ethsnarks.hpp"
+#include "../Utils/ConstraintOptimizer.h"
 #include "../Utils/Data.h"
 
+#include <memory>
+
 using namespace ethsnarks;
 
 namespace Loopring
@@ -21,14 +24,46 @@ class Circuit : public GadgetT
     virtual ~Circuit(){};
     virtual void generateConstraints(unsigned int blockSize) = 0;
     virtual bool generateWitness(const json &input) = 0;
+    virtual bool generateWitness(const Block &block) = 0;
     virtual unsigned int getBlockType() = 0;
     virtual unsigned int getBlockSize() = 0;
     virtual void printInfo() = 0;
 
+    // Where the constraint at `index` comes from, e.g. to report an unsatisfied constraint
+    virtual std::string describeConstraint(size_t index)
+    {
+        return "";
+    }
+
     libsnark::protoboard<FieldT> &getPb()
     {
         return pb;
     }
+
+    // Proves the optimized constraint system instead of the circuit's own, the
+    // keys need to be generated for the optimized system as well
+    void optimizeConstraintSystem()
+    {
+        optimized.reset(new OptimizedConstraintSystem(pb));
+    }
+
+    // Copies the witness to the optimized constraint system, call after generateWitness
+    void assignOptimizedWitness()
+    {
+        if (optimized)
+        {
+            optimized->assign(pb);
+        }
+    }
+
+    // The constraint system and witness passed to the prover
+    libsnark::protoboard<FieldT> &getProvingPb()
+    {
+        return optimized ? optimized->pb : pb;
+    }
+
+  private:
+    std::unique_ptr<OptimizedConstraintSystem> optimized;
 };
 
 } // namespace Loopring
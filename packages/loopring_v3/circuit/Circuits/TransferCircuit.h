@@ -349,7 +349,7 @@ class TransferCircuit : public BaseTransactionCircuit
             isConditional.result(),
             FMT(prefix, ".numConditionalTransactionsAfter"))
     {
-        LOG("Debug", "in TransferCircuit", "");
+        LOG(LogDebug, "in TransferCircuit", "");
         // Update the From account
         setArrayOutput(TXV_ACCOUNT_A_ADDRESS, fromAccountID.bits);
 
@@ -7,7 +7,10 @@
 #include "Circuit.h"
 #include "../Utils/Constants.h"
 #include "../Utils/Data.h"
+#include "../Utils/BlockLayout.h"
 #include "../Utils/Utils.h"
+#include "../Utils/TaskGraph.h"
+#include "../Utils/CircuitStats.h"
 #include "../Gadgets/MatchingGadgets.h"
 #include "../Gadgets/AccountGadgets.h"
 #include "../Gadgets/StorageGadgets.h"
@@ -41,10 +44,11 @@ namespace Loopring
 class SelectTransactionGadget : public BaseTransactionCircuit
 {
   public:
-    std::vector<SelectGadget> uSelects;
-    std::vector<ArraySelectGadget> aSelects;
-    std::vector<ArraySelectGadget> publicDataSelects;
-    
+    // The selector is one-hot (SelectorGadget)
+    std::vector<OneHotSelectGadget> uSelects;
+    std::vector<OneHotArraySelectGadget> aSelects;
+    std::vector<OneHotArraySelectGadget> publicDataSelects;
+
     SelectTransactionGadget(
       ProtoboardT &pb,
       const TransactionState &state,
@@ -550,10 +554,38 @@ class BatchStorageFUpdateGadget : public GadgetT
     }
 };
 
+// Relative cost of generating the witness of a transaction, used to start the
+// heaviest transactions first
+static double getWitnessWeight(const FieldT &txType)
+{
+    switch (TransactionType(UInt256(txType).toUint64()))
+    {
+        case TransactionType::Noop:
+            return 1;
+        case TransactionType::Deposit:
+        case TransactionType::Withdrawal:
+        case TransactionType::AccountUpdate:
+        case TransactionType::OrderCancel:
+        case TransactionType::AppKeyUpdate:
+            return 2;
+        case TransactionType::Transfer:
+            return 3;
+        case TransactionType::SpotTrade:
+            return 4;
+        case TransactionType::BatchSpotTrade:
+            return 8;
+        default:
+            return 1;
+    }
+}
+
 class TransactionGadget : public GadgetT
 {
   public:
     const Constants &constants;
+    // Light slots only support the light transaction types (see BlockLayout),
+    // the gadgets only needed by the other types are not created
+    const bool full;
 
     SelectorGadget selector;
 
@@ -561,30 +593,30 @@ class TransactionGadget : public GadgetT
 
     // Process transaction
     NoopCircuit noop;
-    SpotTradeCircuit spotTrade;
+    std::unique_ptr<SpotTradeCircuit> spotTrade;
     DepositCircuit deposit;
     WithdrawCircuit withdraw;
     AccountUpdateCircuit accountUpdate;
     TransferCircuit transfer;
-    OrderCancelCircuit orderCancel;
-    AppKeyUpdateCircuit appKeyUpdate;
-    BatchSpotTradeCircuit batchSpotTrade;
+    std::unique_ptr<OrderCancelCircuit> orderCancel;
+    std::unique_ptr<AppKeyUpdateCircuit> appKeyUpdate;
+    std::unique_ptr<BatchSpotTradeCircuit> batchSpotTrade;
 
     SelectTransactionGadget tx;
 
     // verify signatures
     SignatureVerifier signatureVerifierA;
     SignatureVerifier signatureVerifierB;
-    BatchSignatureVerifier batchSignatureVerifierA;
-    BatchSignatureVerifier batchSignatureVerifierB;
-    BatchSignatureVerifier batchSignatureVerifierC;
-    BatchSignatureVerifier batchSignatureVerifierD;
-    BatchSignatureVerifier batchSignatureVerifierE;
-    BatchSignatureVerifier batchSignatureVerifierF;
+    std::unique_ptr<BatchSignatureVerifier> batchSignatureVerifierA;
+    std::unique_ptr<BatchSignatureVerifier> batchSignatureVerifierB;
+    std::unique_ptr<BatchSignatureVerifier> batchSignatureVerifierC;
+    std::unique_ptr<BatchSignatureVerifier> batchSignatureVerifierD;
+    std::unique_ptr<BatchSignatureVerifier> batchSignatureVerifierE;
+    std::unique_ptr<BatchSignatureVerifier> batchSignatureVerifierF;
 
     // Update UserA
     UpdateStorageGadget updateStorage_A;
-    BatchStorageAUpdateGadget updateStorage_A_batch;
+    std::unique_ptr<BatchStorageAUpdateGadget> updateStorage_A_batch;
     UpdateBalanceGadget updateBalanceS_A;
     UpdateBalanceGadget updateBalanceB_A;
     UpdateBalanceGadget updateBalanceFee_A;
@@ -592,39 +624,39 @@ class TransactionGadget : public GadgetT
 
     // Update UserB
     UpdateStorageGadget updateStorage_B;
-    BatchStorageBUpdateGadget updateStorage_B_batch;
+    std::unique_ptr<BatchStorageBUpdateGadget> updateStorage_B_batch;
     UpdateBalanceGadget updateBalanceS_B;
     UpdateBalanceGadget updateBalanceB_B;
     UpdateBalanceGadget updateBalanceFee_B;
     UpdateAccountGadget updateAccount_B;
 
     // Update UserC
-    BatchStorageCUpdateGadget updateStorage_C_batch;
-    UpdateBalanceGadget updateBalanceS_C;
-    UpdateBalanceGadget updateBalanceB_C;
-    UpdateBalanceGadget updateBalanceFee_C;
-    UpdateAccountGadget updateAccount_C;
+    std::unique_ptr<BatchStorageCUpdateGadget> updateStorage_C_batch;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceS_C;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceB_C;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceFee_C;
+    std::unique_ptr<UpdateAccountGadget> updateAccount_C;
 
     // Update UserD
-    BatchStorageDUpdateGadget updateStorage_D_batch;
-    UpdateBalanceGadget updateBalanceS_D;
-    UpdateBalanceGadget updateBalanceB_D;
-    UpdateBalanceGadget updateBalanceFee_D;
-    UpdateAccountGadget updateAccount_D;
+    std::unique_ptr<BatchStorageDUpdateGadget> updateStorage_D_batch;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceS_D;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceB_D;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceFee_D;
+    std::unique_ptr<UpdateAccountGadget> updateAccount_D;
 
     // Update UserE
-    BatchStorageEUpdateGadget updateStorage_E_batch;
-    UpdateBalanceGadget updateBalanceS_E;
-    UpdateBalanceGadget updateBalanceB_E;
-    UpdateBalanceGadget updateBalanceFee_E;
-    UpdateAccountGadget updateAccount_E;
+    std::unique_ptr<BatchStorageEUpdateGadget> updateStorage_E_batch;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceS_E;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceB_E;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceFee_E;
+    std::unique_ptr<UpdateAccountGadget> updateAccount_E;
 
     // Update UserF
-    BatchStorageFUpdateGadget updateStorage_F_batch;
-    UpdateBalanceGadget updateBalanceS_F;
-    UpdateBalanceGadget updateBalanceB_F;
-    UpdateBalanceGadget updateBalanceFee_F;
-    UpdateAccountGadget updateAccount_F;
+    std::unique_ptr<BatchStorageFUpdateGadget> updateStorage_F_batch;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceS_F;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceB_F;
+    std::unique_ptr<UpdateBalanceGadget> updateBalanceFee_F;
+    std::unique_ptr<UpdateAccountGadget> updateAccount_F;
 
     // Update Operator
     UpdateBalanceGadget updateBalanceD_O;
@@ -645,12 +677,15 @@ class TransactionGadget : public GadgetT
       const VariableArrayT &operatorAccountID,
       const VariableT &numConditionalTransactionsBefore,
       const VariableT type,
-      const std::string &prefix)
+      bool _full,
+      const std::string &prefix,
+      const PublicKeyRoots *publicKeyRoots = nullptr)
         : GadgetT(pb, prefix),
 
           constants(_constants),
+          full(_full),
 
-          selector(pb, constants, type, (unsigned int)TransactionType::COUNT, FMT(prefix, ".selector")),
+          selector(pb, constants, type, getSlotTransactionTypes(full), FMT(prefix, ".selector")),
 
           state(
             pb,
@@ -661,25 +696,25 @@ class TransactionGadget : public GadgetT
             protocolFeeBips,
             numConditionalTransactionsBefore,
             type,
-            FMT(prefix, ".transactionState")),
+            FMT(prefix, ".transactionState"),
+            publicKeyRoots),
 
           // Process transaction
           noop(pb, state, FMT(prefix, ".noop")),
-          spotTrade(pb, state, FMT(prefix, ".spotTrade")),
+          spotTrade(full ? new SpotTradeCircuit(pb, state, FMT(prefix, ".spotTrade")) : nullptr),
           deposit(pb, state, FMT(prefix, ".deposit")),
           withdraw(pb, state, FMT(prefix, ".withdraw")),
           accountUpdate(pb, state, FMT(prefix, ".accountUpdate")),
           transfer(pb, state, FMT(prefix, ".transfer")),
-          orderCancel(pb, state, FMT(prefix, ".orderCancel")),
-          appKeyUpdate(pb, state, FMT(prefix, ".appKeyUpdate")),
-          batchSpotTrade(pb, state, FMT(prefix, ".batchSpotTrade")),
+          orderCancel(full ? new OrderCancelCircuit(pb, state, FMT(prefix, ".orderCancel")) : nullptr),
+          appKeyUpdate(full ? new AppKeyUpdateCircuit(pb, state, FMT(prefix, ".appKeyUpdate")) : nullptr),
+          batchSpotTrade(full ? new BatchSpotTradeCircuit(pb, state, FMT(prefix, ".batchSpotTrade")) : nullptr),
 
           tx(
             pb,
             state,
             selector.result(),
-            {&noop, &transfer, &spotTrade, &orderCancel, &appKeyUpdate, &batchSpotTrade, 
-            &deposit, &accountUpdate, &withdraw},
+            getTransactionCircuits(getSlotTransactionTypes(full)),
             FMT(prefix, ".tx")),
 
           // Check signatures
@@ -700,59 +735,71 @@ class TransactionGadget : public GadgetT
             tx.getOutput(TXV_SIGNATURE_REQUIRED_B),
             FMT(prefix, ".signatureVerifierB")),
           batchSignatureVerifierA(
-            pb,
-            params,
-            state.constants,
-            tx.getArrayOutput(TXV_PUBKEY_X_A_ARRAY),
-            tx.getArrayOutput(TXV_PUBKEY_Y_A_ARRAY),
-            tx.getArrayOutput(TXV_HASH_A_ARRAY),
-            tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_A_ARRAY),
-            FMT(prefix, ".batchSignatureVerifierA")),
+            full ? new BatchSignatureVerifier(
+                     pb,
+                     params,
+                     state.constants,
+                     tx.getArrayOutput(TXV_PUBKEY_X_A_ARRAY),
+                     tx.getArrayOutput(TXV_PUBKEY_Y_A_ARRAY),
+                     tx.getArrayOutput(TXV_HASH_A_ARRAY),
+                     tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_A_ARRAY),
+                     FMT(prefix, ".batchSignatureVerifierA"))
+                 : nullptr),
           batchSignatureVerifierB(
-            pb,
-            params,
-            state.constants,
-            tx.getArrayOutput(TXV_PUBKEY_X_B_ARRAY),
-            tx.getArrayOutput(TXV_PUBKEY_Y_B_ARRAY),
-            tx.getArrayOutput(TXV_HASH_B_ARRAY),
-            tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_B_ARRAY),
-            FMT(prefix, ".batchSignatureVerifierB")),
+            full ? new BatchSignatureVerifier(
+                     pb,
+                     params,
+                     state.constants,
+                     tx.getArrayOutput(TXV_PUBKEY_X_B_ARRAY),
+                     tx.getArrayOutput(TXV_PUBKEY_Y_B_ARRAY),
+                     tx.getArrayOutput(TXV_HASH_B_ARRAY),
+                     tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_B_ARRAY),
+                     FMT(prefix, ".batchSignatureVerifierB"))
+                 : nullptr),
           batchSignatureVerifierC(
-            pb,
-            params,
-            state.constants,
-            tx.getArrayOutput(TXV_PUBKEY_X_C_ARRAY),
-            tx.getArrayOutput(TXV_PUBKEY_Y_C_ARRAY),
-            tx.getArrayOutput(TXV_HASH_C_ARRAY),
-            tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_C_ARRAY),
-            FMT(prefix, ".batchSignatureVerifierC")),
+            full ? new BatchSignatureVerifier(
+                     pb,
+                     params,
+                     state.constants,
+                     tx.getArrayOutput(TXV_PUBKEY_X_C_ARRAY),
+                     tx.getArrayOutput(TXV_PUBKEY_Y_C_ARRAY),
+                     tx.getArrayOutput(TXV_HASH_C_ARRAY),
+                     tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_C_ARRAY),
+                     FMT(prefix, ".batchSignatureVerifierC"))
+                 : nullptr),
           batchSignatureVerifierD(
-            pb,
-            params,
-            state.constants,
-            tx.getArrayOutput(TXV_PUBKEY_X_D_ARRAY),
-            tx.getArrayOutput(TXV_PUBKEY_Y_D_ARRAY),
-            tx.getArrayOutput(TXV_HASH_D_ARRAY),
-            tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_D_ARRAY),
-            FMT(prefix, ".batchSignatureVerifierD")),
+            full ? new BatchSignatureVerifier(
+                     pb,
+                     params,
+                     state.constants,
+                     tx.getArrayOutput(TXV_PUBKEY_X_D_ARRAY),
+                     tx.getArrayOutput(TXV_PUBKEY_Y_D_ARRAY),
+                     tx.getArrayOutput(TXV_HASH_D_ARRAY),
+                     tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_D_ARRAY),
+                     FMT(prefix, ".batchSignatureVerifierD"))
+                 : nullptr),
           batchSignatureVerifierE(
-            pb,
-            params,
-            state.constants,
-            tx.getArrayOutput(TXV_PUBKEY_X_E_ARRAY),
-            tx.getArrayOutput(TXV_PUBKEY_Y_E_ARRAY),
-            tx.getArrayOutput(TXV_HASH_E_ARRAY),
-            tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_E_ARRAY),
-            FMT(prefix, ".batchSignatureVerifierE")),
+            full ? new BatchSignatureVerifier(
+                     pb,
+                     params,
+                     state.constants,
+                     tx.getArrayOutput(TXV_PUBKEY_X_E_ARRAY),
+                     tx.getArrayOutput(TXV_PUBKEY_Y_E_ARRAY),
+                     tx.getArrayOutput(TXV_HASH_E_ARRAY),
+                     tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_E_ARRAY),
+                     FMT(prefix, ".batchSignatureVerifierE"))
+                 : nullptr),
           batchSignatureVerifierF(
-            pb,
-            params,
-            state.constants,
-            tx.getArrayOutput(TXV_PUBKEY_X_F_ARRAY),
-            tx.getArrayOutput(TXV_PUBKEY_Y_F_ARRAY),
-            tx.getArrayOutput(TXV_HASH_F_ARRAY),
-            tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_F_ARRAY),
-            FMT(prefix, ".batchSignatureVerifierF")),
+            full ? new BatchSignatureVerifier(
+                     pb,
+                     params,
+                     state.constants,
+                     tx.getArrayOutput(TXV_PUBKEY_X_F_ARRAY),
+                     tx.getArrayOutput(TXV_PUBKEY_Y_F_ARRAY),
+                     tx.getArrayOutput(TXV_HASH_F_ARRAY),
+                     tx.getArrayOutput(TXV_SIGNATURE_REQUIRED_F_ARRAY),
+                     FMT(prefix, ".batchSignatureVerifierF"))
+                 : nullptr),
 
           // Update UserA
           updateStorage_A(
@@ -775,11 +822,13 @@ class TransactionGadget : public GadgetT
             tx.getOutput(TXV_STORAGE_A_FORWARD)},
             FMT(prefix, ".updateStorage_A")),
           updateStorage_A_batch(
-            pb, 
-            tx, 
-            state.accountA, 
-            updateStorage_A.result(), 
-            FMT(prefix, ".updateStorage_A_batch")),
+            full ? new BatchStorageAUpdateGadget(
+                     pb, 
+                     tx, 
+                     state.accountA, 
+                     updateStorage_A.result(), 
+                     FMT(prefix, ".updateStorage_A_batch"))
+                 : nullptr),
           updateBalanceS_A(
             pb,
             state.accountA.account.balancesRoot,
@@ -827,7 +876,7 @@ class TransactionGadget : public GadgetT
              tx.getOutput(TXV_ACCOUNT_A_DISABLE_APPKEY_WITHDRAW_TO_OTHER),
              tx.getOutput(TXV_ACCOUNT_A_DISABLE_APPKEY_TRANSFER_TO_OTHER),
              updateBalanceFee_A.result(),
-             updateStorage_A_batch.getHashRoot()},
+             full ? updateStorage_A_batch->getHashRoot() : updateStorage_A.result()},
             FMT(prefix, ".updateAccount_A")),
 
           // Update UserB
@@ -851,11 +900,13 @@ class TransactionGadget : public GadgetT
             tx.getOutput(TXV_STORAGE_B_FORWARD)},
             FMT(prefix, ".updateStorage_B")),
           updateStorage_B_batch(
-            pb, 
-            tx, 
-            state.accountB, 
-            updateStorage_B.result(), 
-            FMT(prefix, ".updateStorage_B_batch")),
+            full ? new BatchStorageBUpdateGadget(
+                     pb, 
+                     tx, 
+                     state.accountB, 
+                     updateStorage_B.result(), 
+                     FMT(prefix, ".updateStorage_B_batch"))
+                 : nullptr),
           updateBalanceS_B(
             pb,
             state.accountB.account.balancesRoot,
@@ -903,233 +954,273 @@ class TransactionGadget : public GadgetT
              state.accountB.account.disableAppKeyWithdraw,
              state.accountB.account.disableAppKeyTransferToOther,
              updateBalanceFee_B.result(),
-             updateStorage_B_batch.getHashRoot()},
+             full ? updateStorage_B_batch->getHashRoot() : updateStorage_B.result()},
             FMT(prefix, ".updateAccount_B")),
           // Update UserC
           updateStorage_C_batch(
-            pb, 
-            tx, 
-            state.accountC, 
-            state.accountC.account.storageRoot, 
-            FMT(prefix, ".updateStorage_C_batch")),
+            full ? new BatchStorageCUpdateGadget(
+                     pb, 
+                     tx, 
+                     state.accountC, 
+                     state.accountC.account.storageRoot, 
+                     FMT(prefix, ".updateStorage_C_batch"))
+                 : nullptr),
           updateBalanceS_C(
-            pb,
-            state.accountC.account.balancesRoot,
-            tx.getArrayOutput(TXV_BALANCE_C_S_ADDRESS),
-            {state.accountC.balanceS.balance},
-            {tx.getOutput(TXV_BALANCE_C_S_BALANCE)},
-            FMT(prefix, ".updateBalanceS_C")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     state.accountC.account.balancesRoot,
+                     tx.getArrayOutput(TXV_BALANCE_C_S_ADDRESS),
+                     {state.accountC.balanceS.balance},
+                     {tx.getOutput(TXV_BALANCE_C_S_BALANCE)},
+                     FMT(prefix, ".updateBalanceS_C"))
+                 : nullptr),
           updateBalanceB_C(
-            pb,
-            updateBalanceS_C.result(),
-            tx.getArrayOutput(TXV_BALANCE_C_B_ADDRESS),
-            {state.accountC.balanceB.balance},
-            {tx.getOutput(TXV_BALANCE_C_B_BALANCE)},
-            FMT(prefix, ".updateBalanceB_C")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceS_C->result(),
+                     tx.getArrayOutput(TXV_BALANCE_C_B_ADDRESS),
+                     {state.accountC.balanceB.balance},
+                     {tx.getOutput(TXV_BALANCE_C_B_BALANCE)},
+                     FMT(prefix, ".updateBalanceB_C"))
+                 : nullptr),
           updateBalanceFee_C(
-            pb,
-            updateBalanceB_C.result(),
-            tx.getArrayOutput(TXV_BALANCE_C_FEE_Address),
-            {state.accountC.balanceFee.balance},
-            {tx.getOutput(TXV_BALANCE_C_FEE_BALANCE)},
-            FMT(prefix, ".updateBalanceFee_C")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceB_C->result(),
+                     tx.getArrayOutput(TXV_BALANCE_C_FEE_Address),
+                     {state.accountC.balanceFee.balance},
+                     {tx.getOutput(TXV_BALANCE_C_FEE_BALANCE)},
+                     FMT(prefix, ".updateBalanceFee_C"))
+                 : nullptr),
           updateAccount_C(
-            pb,
-            updateAccount_B.result(),
-            updateAccount_B.assetResult(),
-            tx.getArrayOutput(TXV_ACCOUNT_C_ADDRESS),
-            {state.accountC.account.owner,
-             state.accountC.account.publicKey.x,
-             state.accountC.account.publicKey.y,
-             state.accountC.account.appKeyPublicKey.x,
-             state.accountC.account.appKeyPublicKey.y,
-             state.accountC.account.nonce,
-             state.accountC.account.disableAppKeySpotTrade,
-             state.accountC.account.disableAppKeyWithdraw,
-             state.accountC.account.disableAppKeyTransferToOther,
-             state.accountC.account.balancesRoot,
-             state.accountC.account.storageRoot},
-            {tx.getOutput(TXV_ACCOUNT_C_OWNER),
-             tx.getOutput(TXV_ACCOUNT_C_PUBKEY_X),
-             tx.getOutput(TXV_ACCOUNT_C_PUBKEY_Y),
-             state.accountC.account.appKeyPublicKey.x,
-             state.accountC.account.appKeyPublicKey.y,
-             tx.getOutput(TXV_ACCOUNT_C_NONCE),
-             state.accountC.account.disableAppKeySpotTrade,
-             state.accountC.account.disableAppKeyWithdraw,
-             state.accountC.account.disableAppKeyTransferToOther,
-             updateBalanceFee_C.result(),
-             updateStorage_C_batch.getHashRoot()},
-            FMT(prefix, ".updateAccount_C")),          
+            full ? new UpdateAccountGadget(
+                     pb,
+                     updateAccount_B.result(),
+                     updateAccount_B.assetResult(),
+                     tx.getArrayOutput(TXV_ACCOUNT_C_ADDRESS),
+                     {state.accountC.account.owner,
+                      state.accountC.account.publicKey.x,
+                      state.accountC.account.publicKey.y,
+                      state.accountC.account.appKeyPublicKey.x,
+                      state.accountC.account.appKeyPublicKey.y,
+                      state.accountC.account.nonce,
+                      state.accountC.account.disableAppKeySpotTrade,
+                      state.accountC.account.disableAppKeyWithdraw,
+                      state.accountC.account.disableAppKeyTransferToOther,
+                      state.accountC.account.balancesRoot,
+                      state.accountC.account.storageRoot},
+                     {tx.getOutput(TXV_ACCOUNT_C_OWNER),
+                      tx.getOutput(TXV_ACCOUNT_C_PUBKEY_X),
+                      tx.getOutput(TXV_ACCOUNT_C_PUBKEY_Y),
+                      state.accountC.account.appKeyPublicKey.x,
+                      state.accountC.account.appKeyPublicKey.y,
+                      tx.getOutput(TXV_ACCOUNT_C_NONCE),
+                      state.accountC.account.disableAppKeySpotTrade,
+                      state.accountC.account.disableAppKeyWithdraw,
+                      state.accountC.account.disableAppKeyTransferToOther,
+                      updateBalanceFee_C->result(),
+                      updateStorage_C_batch->getHashRoot()},
+                     FMT(prefix, ".updateAccount_C"))
+                 : nullptr),          
           // Update UserD
           updateStorage_D_batch(
-            pb, 
-            tx, 
-            state.accountD, 
-            state.accountD.account.storageRoot, 
-            FMT(prefix, ".updateStorage_D_batch")),
+            full ? new BatchStorageDUpdateGadget(
+                     pb, 
+                     tx, 
+                     state.accountD, 
+                     state.accountD.account.storageRoot, 
+                     FMT(prefix, ".updateStorage_D_batch"))
+                 : nullptr),
           updateBalanceS_D(
-            pb,
-            state.accountD.account.balancesRoot,
-            tx.getArrayOutput(TXV_BALANCE_D_S_ADDRESS),
-            {state.accountD.balanceS.balance},
-            {tx.getOutput(TXV_BALANCE_D_S_BALANCE)},
-            FMT(prefix, ".updateBalanceS_D")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     state.accountD.account.balancesRoot,
+                     tx.getArrayOutput(TXV_BALANCE_D_S_ADDRESS),
+                     {state.accountD.balanceS.balance},
+                     {tx.getOutput(TXV_BALANCE_D_S_BALANCE)},
+                     FMT(prefix, ".updateBalanceS_D"))
+                 : nullptr),
           updateBalanceB_D(
-            pb,
-            updateBalanceS_D.result(),
-            tx.getArrayOutput(TXV_BALANCE_D_B_ADDRESS),
-            {state.accountD.balanceB.balance},
-            {tx.getOutput(TXV_BALANCE_D_B_BALANCE)},
-            FMT(prefix, ".updateBalanceB_D")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceS_D->result(),
+                     tx.getArrayOutput(TXV_BALANCE_D_B_ADDRESS),
+                     {state.accountD.balanceB.balance},
+                     {tx.getOutput(TXV_BALANCE_D_B_BALANCE)},
+                     FMT(prefix, ".updateBalanceB_D"))
+                 : nullptr),
           updateBalanceFee_D(
-            pb,
-            updateBalanceB_D.result(),
-            tx.getArrayOutput(TXV_BALANCE_D_FEE_Address),
-            {state.accountD.balanceFee.balance},
-            {tx.getOutput(TXV_BALANCE_D_FEE_BALANCE)},
-            FMT(prefix, ".updateBalanceFee_D")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceB_D->result(),
+                     tx.getArrayOutput(TXV_BALANCE_D_FEE_Address),
+                     {state.accountD.balanceFee.balance},
+                     {tx.getOutput(TXV_BALANCE_D_FEE_BALANCE)},
+                     FMT(prefix, ".updateBalanceFee_D"))
+                 : nullptr),
           updateAccount_D(
-            pb,
-            updateAccount_C.result(),
-            updateAccount_C.assetResult(),
-            tx.getArrayOutput(TXV_ACCOUNT_D_ADDRESS),
-            {state.accountD.account.owner,
-             state.accountD.account.publicKey.x,
-             state.accountD.account.publicKey.y,
-             state.accountD.account.appKeyPublicKey.x,
-             state.accountD.account.appKeyPublicKey.y,
-             state.accountD.account.nonce,
-             state.accountD.account.disableAppKeySpotTrade,
-             state.accountD.account.disableAppKeyWithdraw,
-             state.accountD.account.disableAppKeyTransferToOther,
-             state.accountD.account.balancesRoot,
-             state.accountD.account.storageRoot},
-            {tx.getOutput(TXV_ACCOUNT_D_OWNER),
-             tx.getOutput(TXV_ACCOUNT_D_PUBKEY_X),
-             tx.getOutput(TXV_ACCOUNT_D_PUBKEY_Y),
-             state.accountD.account.appKeyPublicKey.x,
-             state.accountD.account.appKeyPublicKey.y,
-             tx.getOutput(TXV_ACCOUNT_D_NONCE),
-             state.accountD.account.disableAppKeySpotTrade,
-             state.accountD.account.disableAppKeyWithdraw,
-             state.accountD.account.disableAppKeyTransferToOther,
-             updateBalanceFee_D.result(),
-             updateStorage_D_batch.getHashRoot()},
-            FMT(prefix, ".updateAccount_D")),
+            full ? new UpdateAccountGadget(
+                     pb,
+                     updateAccount_C->result(),
+                     updateAccount_C->assetResult(),
+                     tx.getArrayOutput(TXV_ACCOUNT_D_ADDRESS),
+                     {state.accountD.account.owner,
+                      state.accountD.account.publicKey.x,
+                      state.accountD.account.publicKey.y,
+                      state.accountD.account.appKeyPublicKey.x,
+                      state.accountD.account.appKeyPublicKey.y,
+                      state.accountD.account.nonce,
+                      state.accountD.account.disableAppKeySpotTrade,
+                      state.accountD.account.disableAppKeyWithdraw,
+                      state.accountD.account.disableAppKeyTransferToOther,
+                      state.accountD.account.balancesRoot,
+                      state.accountD.account.storageRoot},
+                     {tx.getOutput(TXV_ACCOUNT_D_OWNER),
+                      tx.getOutput(TXV_ACCOUNT_D_PUBKEY_X),
+                      tx.getOutput(TXV_ACCOUNT_D_PUBKEY_Y),
+                      state.accountD.account.appKeyPublicKey.x,
+                      state.accountD.account.appKeyPublicKey.y,
+                      tx.getOutput(TXV_ACCOUNT_D_NONCE),
+                      state.accountD.account.disableAppKeySpotTrade,
+                      state.accountD.account.disableAppKeyWithdraw,
+                      state.accountD.account.disableAppKeyTransferToOther,
+                      updateBalanceFee_D->result(),
+                      updateStorage_D_batch->getHashRoot()},
+                     FMT(prefix, ".updateAccount_D"))
+                 : nullptr),
           // Update UserE
           updateStorage_E_batch(
-            pb, 
-            tx, 
-            state.accountE, 
-            state.accountE.account.storageRoot, 
-            FMT(prefix, ".updateStorage_E_batch")),
+            full ? new BatchStorageEUpdateGadget(
+                     pb, 
+                     tx, 
+                     state.accountE, 
+                     state.accountE.account.storageRoot, 
+                     FMT(prefix, ".updateStorage_E_batch"))
+                 : nullptr),
           updateBalanceS_E(
-            pb,
-            state.accountE.account.balancesRoot,
-            tx.getArrayOutput(TXV_BALANCE_E_S_ADDRESS),
-            {state.accountE.balanceS.balance},
-            {tx.getOutput(TXV_BALANCE_E_S_BALANCE)},
-            FMT(prefix, ".updateBalanceS_E")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     state.accountE.account.balancesRoot,
+                     tx.getArrayOutput(TXV_BALANCE_E_S_ADDRESS),
+                     {state.accountE.balanceS.balance},
+                     {tx.getOutput(TXV_BALANCE_E_S_BALANCE)},
+                     FMT(prefix, ".updateBalanceS_E"))
+                 : nullptr),
           updateBalanceB_E(
-            pb,
-            updateBalanceS_E.result(),
-            tx.getArrayOutput(TXV_BALANCE_E_B_ADDRESS),
-            {state.accountE.balanceB.balance},
-            {tx.getOutput(TXV_BALANCE_E_B_BALANCE)},
-            FMT(prefix, ".updateBalanceB_E")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceS_E->result(),
+                     tx.getArrayOutput(TXV_BALANCE_E_B_ADDRESS),
+                     {state.accountE.balanceB.balance},
+                     {tx.getOutput(TXV_BALANCE_E_B_BALANCE)},
+                     FMT(prefix, ".updateBalanceB_E"))
+                 : nullptr),
           updateBalanceFee_E(
-            pb,
-            updateBalanceB_E.result(),
-            tx.getArrayOutput(TXV_BALANCE_E_FEE_Address),
-            {state.accountE.balanceFee.balance},
-            {tx.getOutput(TXV_BALANCE_E_FEE_BALANCE)},
-            FMT(prefix, ".updateBalanceFee_E")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceB_E->result(),
+                     tx.getArrayOutput(TXV_BALANCE_E_FEE_Address),
+                     {state.accountE.balanceFee.balance},
+                     {tx.getOutput(TXV_BALANCE_E_FEE_BALANCE)},
+                     FMT(prefix, ".updateBalanceFee_E"))
+                 : nullptr),
           updateAccount_E(
-            pb,
-            updateAccount_D.result(),
-            updateAccount_D.assetResult(),
-            tx.getArrayOutput(TXV_ACCOUNT_E_ADDRESS),
-            {state.accountE.account.owner,
-             state.accountE.account.publicKey.x,
-             state.accountE.account.publicKey.y,
-             state.accountE.account.appKeyPublicKey.x,
-             state.accountE.account.appKeyPublicKey.y,
-             state.accountE.account.nonce,
-             state.accountE.account.disableAppKeySpotTrade,
-             state.accountE.account.disableAppKeyWithdraw,
-             state.accountE.account.disableAppKeyTransferToOther,
-             state.accountE.account.balancesRoot,
-             state.accountE.account.storageRoot},
-            {tx.getOutput(TXV_ACCOUNT_E_OWNER),
-             tx.getOutput(TXV_ACCOUNT_E_PUBKEY_X),
-             tx.getOutput(TXV_ACCOUNT_E_PUBKEY_Y),
-             state.accountE.account.appKeyPublicKey.x,
-             state.accountE.account.appKeyPublicKey.y,
-             tx.getOutput(TXV_ACCOUNT_E_NONCE),
-             state.accountE.account.disableAppKeySpotTrade,
-             state.accountE.account.disableAppKeyWithdraw,
-             state.accountE.account.disableAppKeyTransferToOther,
-             updateBalanceFee_E.result(),
-             updateStorage_E_batch.getHashRoot()},
-            FMT(prefix, ".updateAccount_E")),   
+            full ? new UpdateAccountGadget(
+                     pb,
+                     updateAccount_D->result(),
+                     updateAccount_D->assetResult(),
+                     tx.getArrayOutput(TXV_ACCOUNT_E_ADDRESS),
+                     {state.accountE.account.owner,
+                      state.accountE.account.publicKey.x,
+                      state.accountE.account.publicKey.y,
+                      state.accountE.account.appKeyPublicKey.x,
+                      state.accountE.account.appKeyPublicKey.y,
+                      state.accountE.account.nonce,
+                      state.accountE.account.disableAppKeySpotTrade,
+                      state.accountE.account.disableAppKeyWithdraw,
+                      state.accountE.account.disableAppKeyTransferToOther,
+                      state.accountE.account.balancesRoot,
+                      state.accountE.account.storageRoot},
+                     {tx.getOutput(TXV_ACCOUNT_E_OWNER),
+                      tx.getOutput(TXV_ACCOUNT_E_PUBKEY_X),
+                      tx.getOutput(TXV_ACCOUNT_E_PUBKEY_Y),
+                      state.accountE.account.appKeyPublicKey.x,
+                      state.accountE.account.appKeyPublicKey.y,
+                      tx.getOutput(TXV_ACCOUNT_E_NONCE),
+                      state.accountE.account.disableAppKeySpotTrade,
+                      state.accountE.account.disableAppKeyWithdraw,
+                      state.accountE.account.disableAppKeyTransferToOther,
+                      updateBalanceFee_E->result(),
+                      updateStorage_E_batch->getHashRoot()},
+                     FMT(prefix, ".updateAccount_E"))
+                 : nullptr),   
 
           // Update UserF
           updateStorage_F_batch(
-            pb, 
-            tx, 
-            state.accountF, 
-            state.accountF.account.storageRoot, 
-            FMT(prefix, ".updateStorage_F_batch")),
+            full ? new BatchStorageFUpdateGadget(
+                     pb, 
+                     tx, 
+                     state.accountF, 
+                     state.accountF.account.storageRoot, 
+                     FMT(prefix, ".updateStorage_F_batch"))
+                 : nullptr),
           updateBalanceS_F(
-            pb,
-            state.accountF.account.balancesRoot,
-            tx.getArrayOutput(TXV_BALANCE_F_S_ADDRESS),
-            {state.accountF.balanceS.balance},
-            {tx.getOutput(TXV_BALANCE_F_S_BALANCE)},
-            FMT(prefix, ".updateBalanceS_F")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     state.accountF.account.balancesRoot,
+                     tx.getArrayOutput(TXV_BALANCE_F_S_ADDRESS),
+                     {state.accountF.balanceS.balance},
+                     {tx.getOutput(TXV_BALANCE_F_S_BALANCE)},
+                     FMT(prefix, ".updateBalanceS_F"))
+                 : nullptr),
           updateBalanceB_F(
-            pb,
-            updateBalanceS_F.result(),
-            tx.getArrayOutput(TXV_BALANCE_F_B_ADDRESS),
-            {state.accountF.balanceB.balance},
-            {tx.getOutput(TXV_BALANCE_F_B_BALANCE)},
-            FMT(prefix, ".updateBalanceB_F")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceS_F->result(),
+                     tx.getArrayOutput(TXV_BALANCE_F_B_ADDRESS),
+                     {state.accountF.balanceB.balance},
+                     {tx.getOutput(TXV_BALANCE_F_B_BALANCE)},
+                     FMT(prefix, ".updateBalanceB_F"))
+                 : nullptr),
           updateBalanceFee_F(
-            pb,
-            updateBalanceB_F.result(),
-            tx.getArrayOutput(TXV_BALANCE_F_FEE_Address),
-            {state.accountF.balanceFee.balance},
-            {tx.getOutput(TXV_BALANCE_F_FEE_BALANCE)},
-            FMT(prefix, ".updateBalanceFee_F")),
+            full ? new UpdateBalanceGadget(
+                     pb,
+                     updateBalanceB_F->result(),
+                     tx.getArrayOutput(TXV_BALANCE_F_FEE_Address),
+                     {state.accountF.balanceFee.balance},
+                     {tx.getOutput(TXV_BALANCE_F_FEE_BALANCE)},
+                     FMT(prefix, ".updateBalanceFee_F"))
+                 : nullptr),
           updateAccount_F(
-            pb,
-            updateAccount_E.result(),
-            updateAccount_E.assetResult(),
-            tx.getArrayOutput(TXV_ACCOUNT_F_ADDRESS),
-            {state.accountF.account.owner,
-             state.accountF.account.publicKey.x,
-             state.accountF.account.publicKey.y,
-             state.accountF.account.appKeyPublicKey.x,
-             state.accountF.account.appKeyPublicKey.y,
-             state.accountF.account.nonce,
-             state.accountF.account.disableAppKeySpotTrade,
-             state.accountF.account.disableAppKeyWithdraw,
-             state.accountF.account.disableAppKeyTransferToOther,
-             state.accountF.account.balancesRoot,
-             state.accountF.account.storageRoot},
-            {tx.getOutput(TXV_ACCOUNT_F_OWNER),
-             tx.getOutput(TXV_ACCOUNT_F_PUBKEY_X),
-             tx.getOutput(TXV_ACCOUNT_F_PUBKEY_Y),
-             state.accountF.account.appKeyPublicKey.x,
-             state.accountF.account.appKeyPublicKey.y,
-             tx.getOutput(TXV_ACCOUNT_F_NONCE),
-             state.accountF.account.disableAppKeySpotTrade,
-             state.accountF.account.disableAppKeyWithdraw,
-             state.accountF.account.disableAppKeyTransferToOther,
-             updateBalanceFee_F.result(),
-             updateStorage_F_batch.getHashRoot()},
-            FMT(prefix, ".updateAccount_F")),   
+            full ? new UpdateAccountGadget(
+                     pb,
+                     updateAccount_E->result(),
+                     updateAccount_E->assetResult(),
+                     tx.getArrayOutput(TXV_ACCOUNT_F_ADDRESS),
+                     {state.accountF.account.owner,
+                      state.accountF.account.publicKey.x,
+                      state.accountF.account.publicKey.y,
+                      state.accountF.account.appKeyPublicKey.x,
+                      state.accountF.account.appKeyPublicKey.y,
+                      state.accountF.account.nonce,
+                      state.accountF.account.disableAppKeySpotTrade,
+                      state.accountF.account.disableAppKeyWithdraw,
+                      state.accountF.account.disableAppKeyTransferToOther,
+                      state.accountF.account.balancesRoot,
+                      state.accountF.account.storageRoot},
+                     {tx.getOutput(TXV_ACCOUNT_F_OWNER),
+                      tx.getOutput(TXV_ACCOUNT_F_PUBKEY_X),
+                      tx.getOutput(TXV_ACCOUNT_F_PUBKEY_Y),
+                      state.accountF.account.appKeyPublicKey.x,
+                      state.accountF.account.appKeyPublicKey.y,
+                      tx.getOutput(TXV_ACCOUNT_F_NONCE),
+                      state.accountF.account.disableAppKeySpotTrade,
+                      state.accountF.account.disableAppKeyWithdraw,
+                      state.accountF.account.disableAppKeyTransferToOther,
+                      updateBalanceFee_F->result(),
+                      updateStorage_F_batch->getHashRoot()},
+                     FMT(prefix, ".updateAccount_F"))
+                 : nullptr),   
 
           // Update Operator
           updateBalanceD_O(
@@ -1162,8 +1253,8 @@ class TransactionGadget : public GadgetT
             FMT(prefix, ".updateBalanceA_O")),
           updateAccount_O(
             pb,
-            updateAccount_F.result(),
-            updateAccount_F.assetResult(),
+            full ? updateAccount_F->result() : updateAccount_B.result(),
+            full ? updateAccount_F->assetResult() : updateAccount_B.assetResult(),
             operatorAccountID,
             {state.oper.account.owner,
              state.oper.account.publicKey.x,
@@ -1244,14 +1335,17 @@ class TransactionGadget : public GadgetT
           );
 
         noop.generate_r1cs_witness();
-        spotTrade.generate_r1cs_witness(uTx.spotTrade);
         deposit.generate_r1cs_witness(uTx.deposit);
         withdraw.generate_r1cs_witness(uTx.withdraw);
         accountUpdate.generate_r1cs_witness(uTx.accountUpdate);
         transfer.generate_r1cs_witness(uTx.transfer);
-        orderCancel.generate_r1cs_witness(uTx.orderCancel);
-        appKeyUpdate.generate_r1cs_witness(uTx.appKeyUpdate);
-        batchSpotTrade.generate_r1cs_witness(uTx.batchSpotTrade);
+        if (full)
+        {
+            spotTrade->generate_r1cs_witness(uTx.spotTrade);
+            orderCancel->generate_r1cs_witness(uTx.orderCancel);
+            appKeyUpdate->generate_r1cs_witness(uTx.appKeyUpdate);
+            batchSpotTrade->generate_r1cs_witness(uTx.batchSpotTrade);
+        }
         tx.generate_r1cs_witness();
 
 
@@ -1259,17 +1353,23 @@ class TransactionGadget : public GadgetT
         signatureVerifierA.generate_r1cs_witness(uTx.witness.signatureA);
         signatureVerifierB.generate_r1cs_witness(uTx.witness.signatureB);
 
-        batchSignatureVerifierA.generate_r1cs_witness(uTx.witness.signatureArray[0]);
-        batchSignatureVerifierB.generate_r1cs_witness(uTx.witness.signatureArray[1]);
-        batchSignatureVerifierC.generate_r1cs_witness(uTx.witness.signatureArray[2]);
-        batchSignatureVerifierD.generate_r1cs_witness(uTx.witness.signatureArray[3]);
-        batchSignatureVerifierE.generate_r1cs_witness(uTx.witness.signatureArray[4]);
-        batchSignatureVerifierF.generate_r1cs_witness(uTx.witness.signatureArray[5]);
+        if (full)
+        {
+            batchSignatureVerifierA->generate_r1cs_witness(uTx.witness.signatureArray[0]);
+            batchSignatureVerifierB->generate_r1cs_witness(uTx.witness.signatureArray[1]);
+            batchSignatureVerifierC->generate_r1cs_witness(uTx.witness.signatureArray[2]);
+            batchSignatureVerifierD->generate_r1cs_witness(uTx.witness.signatureArray[3]);
+            batchSignatureVerifierE->generate_r1cs_witness(uTx.witness.signatureArray[4]);
+            batchSignatureVerifierF->generate_r1cs_witness(uTx.witness.signatureArray[5]);
+        }
         // Update UserA
         updateStorage_A.generate_r1cs_witness(uTx.witness.storageUpdate_A);
 
         // batch spot trade Storage
-        updateStorage_A_batch.generate_r1cs_witness(uTx.witness.storageUpdate_A_array);
+        if (full)
+        {
+            updateStorage_A_batch->generate_r1cs_witness(uTx.witness.storageUpdate_A_array);
+        }
 
         updateBalanceS_A.generate_r1cs_witness(uTx.witness.balanceUpdateS_A);
         updateBalanceB_A.generate_r1cs_witness(uTx.witness.balanceUpdateB_A);
@@ -1280,47 +1380,53 @@ class TransactionGadget : public GadgetT
         updateStorage_B.generate_r1cs_witness(uTx.witness.storageUpdate_B);
 
         // batch spot trade Storage
-        updateStorage_B_batch.generate_r1cs_witness(uTx.witness.storageUpdate_B_array);
+        if (full)
+        {
+            updateStorage_B_batch->generate_r1cs_witness(uTx.witness.storageUpdate_B_array);
+        }
         updateBalanceS_B.generate_r1cs_witness(uTx.witness.balanceUpdateS_B);
         updateBalanceB_B.generate_r1cs_witness(uTx.witness.balanceUpdateB_B);
         updateBalanceFee_B.generate_r1cs_witness(uTx.witness.balanceUpdateFee_B);
         updateAccount_B.generate_r1cs_witness(uTx.witness.accountUpdate_B);
 
-        // Update UserC
-        // batch spot trade Storage
-        updateStorage_C_batch.generate_r1cs_witness(uTx.witness.storageUpdate_C_array);
-
-        updateBalanceS_C.generate_r1cs_witness(uTx.witness.balanceUpdateS_C);
-        updateBalanceB_C.generate_r1cs_witness(uTx.witness.balanceUpdateB_C);
-        updateBalanceFee_C.generate_r1cs_witness(uTx.witness.balanceUpdateFee_C);
-        updateAccount_C.generate_r1cs_witness(uTx.witness.accountUpdate_C);
-
-        // Update UserD
-        // batch spot trade Storage
-        updateStorage_D_batch.generate_r1cs_witness(uTx.witness.storageUpdate_D_array);
-
-        updateBalanceS_D.generate_r1cs_witness(uTx.witness.balanceUpdateS_D);
-        updateBalanceB_D.generate_r1cs_witness(uTx.witness.balanceUpdateB_D);
-        updateBalanceFee_D.generate_r1cs_witness(uTx.witness.balanceUpdateFee_D);
-        updateAccount_D.generate_r1cs_witness(uTx.witness.accountUpdate_D);
-
-        // Update UserE
-        // batch spot trade Storage
-        updateStorage_E_batch.generate_r1cs_witness(uTx.witness.storageUpdate_E_array);
-
-        updateBalanceS_E.generate_r1cs_witness(uTx.witness.balanceUpdateS_E);
-        updateBalanceB_E.generate_r1cs_witness(uTx.witness.balanceUpdateB_E);
-        updateBalanceFee_E.generate_r1cs_witness(uTx.witness.balanceUpdateFee_E);
-        updateAccount_E.generate_r1cs_witness(uTx.witness.accountUpdate_E);
-
-        // Update UserF
-        // batch spot trade Storage
-        updateStorage_F_batch.generate_r1cs_witness(uTx.witness.storageUpdate_F_array);
-
-        updateBalanceS_F.generate_r1cs_witness(uTx.witness.balanceUpdateS_F);
-        updateBalanceB_F.generate_r1cs_witness(uTx.witness.balanceUpdateB_F);
-        updateBalanceFee_F.generate_r1cs_witness(uTx.witness.balanceUpdateFee_F);
-        updateAccount_F.generate_r1cs_witness(uTx.witness.accountUpdate_F);
+        if (full)
+        {
+            // Update UserC
+            // batch spot trade Storage
+            updateStorage_C_batch->generate_r1cs_witness(uTx.witness.storageUpdate_C_array);
+
+            updateBalanceS_C->generate_r1cs_witness(uTx.witness.balanceUpdateS_C);
+            updateBalanceB_C->generate_r1cs_witness(uTx.witness.balanceUpdateB_C);
+            updateBalanceFee_C->generate_r1cs_witness(uTx.witness.balanceUpdateFee_C);
+            updateAccount_C->generate_r1cs_witness(uTx.witness.accountUpdate_C);
+
+            // Update UserD
+            // batch spot trade Storage
+            updateStorage_D_batch->generate_r1cs_witness(uTx.witness.storageUpdate_D_array);
+
+            updateBalanceS_D->generate_r1cs_witness(uTx.witness.balanceUpdateS_D);
+            updateBalanceB_D->generate_r1cs_witness(uTx.witness.balanceUpdateB_D);
+            updateBalanceFee_D->generate_r1cs_witness(uTx.witness.balanceUpdateFee_D);
+            updateAccount_D->generate_r1cs_witness(uTx.witness.accountUpdate_D);
+
+            // Update UserE
+            // batch spot trade Storage
+            updateStorage_E_batch->generate_r1cs_witness(uTx.witness.storageUpdate_E_array);
+
+            updateBalanceS_E->generate_r1cs_witness(uTx.witness.balanceUpdateS_E);
+            updateBalanceB_E->generate_r1cs_witness(uTx.witness.balanceUpdateB_E);
+            updateBalanceFee_E->generate_r1cs_witness(uTx.witness.balanceUpdateFee_E);
+            updateAccount_E->generate_r1cs_witness(uTx.witness.accountUpdate_E);
+
+            // Update UserF
+            // batch spot trade Storage
+            updateStorage_F_batch->generate_r1cs_witness(uTx.witness.storageUpdate_F_array);
+
+            updateBalanceS_F->generate_r1cs_witness(uTx.witness.balanceUpdateS_F);
+            updateBalanceB_F->generate_r1cs_witness(uTx.witness.balanceUpdateB_F);
+            updateBalanceFee_F->generate_r1cs_witness(uTx.witness.balanceUpdateFee_F);
+            updateAccount_F->generate_r1cs_witness(uTx.witness.accountUpdate_F);
+        }
 
         // Update Operator
         updateBalanceD_O.generate_r1cs_witness(uTx.witness.balanceUpdateD_O);
@@ -1333,82 +1439,139 @@ class TransactionGadget : public GadgetT
 
     void generate_r1cs_constraints()
     {
-        selector.generate_r1cs_constraints();
-
-        noop.generate_r1cs_constraints();
-        spotTrade.generate_r1cs_constraints();
-        deposit.generate_r1cs_constraints();
-        withdraw.generate_r1cs_constraints();
-        accountUpdate.generate_r1cs_constraints();
-        transfer.generate_r1cs_constraints();
-        orderCancel.generate_r1cs_constraints();
-        appKeyUpdate.generate_r1cs_constraints();
-
-        batchSpotTrade.generate_r1cs_constraints();
-        tx.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(selector);
+
+        PROFILE_CONSTRAINTS(noop);
+        PROFILE_CONSTRAINTS(deposit);
+        PROFILE_CONSTRAINTS(withdraw);
+        PROFILE_CONSTRAINTS(accountUpdate);
+        PROFILE_CONSTRAINTS(transfer);
+        if (full)
+        {
+            ConstraintProfiler::generate(*spotTrade, "spotTrade");
+            ConstraintProfiler::generate(*orderCancel, "orderCancel");
+            ConstraintProfiler::generate(*appKeyUpdate, "appKeyUpdate");
+            ConstraintProfiler::generate(*batchSpotTrade, "batchSpotTrade");
+        }
+        PROFILE_CONSTRAINTS(tx);
 
         // Check signatures
-        signatureVerifierA.generate_r1cs_constraints();
-        signatureVerifierB.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(signatureVerifierA);
+        PROFILE_CONSTRAINTS(signatureVerifierB);
 
-        batchSignatureVerifierA.generate_r1cs_constraints();
-        batchSignatureVerifierB.generate_r1cs_constraints();
-        batchSignatureVerifierC.generate_r1cs_constraints();
-        batchSignatureVerifierD.generate_r1cs_constraints();
-        batchSignatureVerifierE.generate_r1cs_constraints();
-        batchSignatureVerifierF.generate_r1cs_constraints();
+        if (full)
+        {
+            ConstraintProfiler::generate(*batchSignatureVerifierA, "batchSignatureVerifierA");
+            ConstraintProfiler::generate(*batchSignatureVerifierB, "batchSignatureVerifierB");
+            ConstraintProfiler::generate(*batchSignatureVerifierC, "batchSignatureVerifierC");
+            ConstraintProfiler::generate(*batchSignatureVerifierD, "batchSignatureVerifierD");
+            ConstraintProfiler::generate(*batchSignatureVerifierE, "batchSignatureVerifierE");
+            ConstraintProfiler::generate(*batchSignatureVerifierF, "batchSignatureVerifierF");
+        }
 
         // Update UserA
-        updateStorage_A.generate_r1cs_constraints();
-        updateStorage_A_batch.generate_r1cs_constraints();
-        updateBalanceS_A.generate_r1cs_constraints();
-        updateBalanceB_A.generate_r1cs_constraints();
-        updateBalanceFee_A.generate_r1cs_constraints();
-        updateAccount_A.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(updateStorage_A);
+        if (full)
+        {
+            ConstraintProfiler::generate(*updateStorage_A_batch, "updateStorage_A_batch");
+        }
+        PROFILE_CONSTRAINTS(updateBalanceS_A);
+        PROFILE_CONSTRAINTS(updateBalanceB_A);
+        PROFILE_CONSTRAINTS(updateBalanceFee_A);
+        PROFILE_CONSTRAINTS(updateAccount_A);
 
         // Update UserB
-        updateStorage_B.generate_r1cs_constraints();
-        updateStorage_B_batch.generate_r1cs_constraints();
-        updateBalanceS_B.generate_r1cs_constraints();
-        updateBalanceB_B.generate_r1cs_constraints();
-        updateBalanceFee_B.generate_r1cs_constraints();
-        updateAccount_B.generate_r1cs_constraints();
-
-        // Update UserC
-        updateStorage_C_batch.generate_r1cs_constraints();
-        updateBalanceS_C.generate_r1cs_constraints();
-        updateBalanceB_C.generate_r1cs_constraints();
-        updateBalanceFee_C.generate_r1cs_constraints();
-        updateAccount_C.generate_r1cs_constraints();
-
-        // Update UserD
-        updateStorage_D_batch.generate_r1cs_constraints();
-        updateBalanceS_D.generate_r1cs_constraints();
-        updateBalanceB_D.generate_r1cs_constraints();
-        updateBalanceFee_D.generate_r1cs_constraints();
-        updateAccount_D.generate_r1cs_constraints();
-
-        // Update UserE
-        updateStorage_E_batch.generate_r1cs_constraints();
-        updateBalanceS_E.generate_r1cs_constraints();
-        updateBalanceB_E.generate_r1cs_constraints();
-        updateBalanceFee_E.generate_r1cs_constraints();
-        updateAccount_E.generate_r1cs_constraints();
-
-        // Update UserF
-        updateStorage_F_batch.generate_r1cs_constraints();
-        updateBalanceS_F.generate_r1cs_constraints();
-        updateBalanceB_F.generate_r1cs_constraints();
-        updateBalanceFee_F.generate_r1cs_constraints();
-        updateAccount_F.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(updateStorage_B);
+        if (full)
+        {
+            ConstraintProfiler::generate(*updateStorage_B_batch, "updateStorage_B_batch");
+        }
+        PROFILE_CONSTRAINTS(updateBalanceS_B);
+        PROFILE_CONSTRAINTS(updateBalanceB_B);
+        PROFILE_CONSTRAINTS(updateBalanceFee_B);
+        PROFILE_CONSTRAINTS(updateAccount_B);
+
+        if (full)
+        {
+            // Update UserC
+            ConstraintProfiler::generate(*updateStorage_C_batch, "updateStorage_C_batch");
+            ConstraintProfiler::generate(*updateBalanceS_C, "updateBalanceS_C");
+            ConstraintProfiler::generate(*updateBalanceB_C, "updateBalanceB_C");
+            ConstraintProfiler::generate(*updateBalanceFee_C, "updateBalanceFee_C");
+            ConstraintProfiler::generate(*updateAccount_C, "updateAccount_C");
+
+            // Update UserD
+            ConstraintProfiler::generate(*updateStorage_D_batch, "updateStorage_D_batch");
+            ConstraintProfiler::generate(*updateBalanceS_D, "updateBalanceS_D");
+            ConstraintProfiler::generate(*updateBalanceB_D, "updateBalanceB_D");
+            ConstraintProfiler::generate(*updateBalanceFee_D, "updateBalanceFee_D");
+            ConstraintProfiler::generate(*updateAccount_D, "updateAccount_D");
+
+            // Update UserE
+            ConstraintProfiler::generate(*updateStorage_E_batch, "updateStorage_E_batch");
+            ConstraintProfiler::generate(*updateBalanceS_E, "updateBalanceS_E");
+            ConstraintProfiler::generate(*updateBalanceB_E, "updateBalanceB_E");
+            ConstraintProfiler::generate(*updateBalanceFee_E, "updateBalanceFee_E");
+            ConstraintProfiler::generate(*updateAccount_E, "updateAccount_E");
+
+            // Update UserF
+            ConstraintProfiler::generate(*updateStorage_F_batch, "updateStorage_F_batch");
+            ConstraintProfiler::generate(*updateBalanceS_F, "updateBalanceS_F");
+            ConstraintProfiler::generate(*updateBalanceB_F, "updateBalanceB_F");
+            ConstraintProfiler::generate(*updateBalanceFee_F, "updateBalanceFee_F");
+            ConstraintProfiler::generate(*updateAccount_F, "updateAccount_F");
+        }
 
         // Update Operator
-        updateBalanceD_O.generate_r1cs_constraints();
-        updateBalanceC_O.generate_r1cs_constraints();
-        updateBalanceB_O.generate_r1cs_constraints();
-        updateBalanceA_O.generate_r1cs_constraints();
-        updateAccount_O.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(updateBalanceD_O);
+        PROFILE_CONSTRAINTS(updateBalanceC_O);
+        PROFILE_CONSTRAINTS(updateBalanceB_O);
+        PROFILE_CONSTRAINTS(updateBalanceA_O);
+        PROFILE_CONSTRAINTS(updateAccount_O);
+
+    }
 
+    // The circuits of `types`, in the same order
+    std::vector<BaseTransactionCircuit *> getTransactionCircuits(const std::vector<unsigned int> &types)
+    {
+        std::vector<BaseTransactionCircuit *> circuits;
+        for (unsigned int type : types)
+        {
+            switch (TransactionType(type))
+            {
+                case TransactionType::Noop:
+                    circuits.push_back(&noop);
+                    break;
+                case TransactionType::Transfer:
+                    circuits.push_back(&transfer);
+                    break;
+                case TransactionType::SpotTrade:
+                    circuits.push_back(spotTrade.get());
+                    break;
+                case TransactionType::OrderCancel:
+                    circuits.push_back(orderCancel.get());
+                    break;
+                case TransactionType::AppKeyUpdate:
+                    circuits.push_back(appKeyUpdate.get());
+                    break;
+                case TransactionType::BatchSpotTrade:
+                    circuits.push_back(batchSpotTrade.get());
+                    break;
+                case TransactionType::Deposit:
+                    circuits.push_back(&deposit);
+                    break;
+                case TransactionType::AccountUpdate:
+                    circuits.push_back(&accountUpdate);
+                    break;
+                case TransactionType::Withdrawal:
+                    circuits.push_back(&withdraw);
+                    break;
+                default:
+                    assert(false);
+            }
+            assert(circuits.back() != nullptr);
+        }
+        return circuits;
     }
 
     const VariableArrayT getPublicData() const
@@ -1457,8 +1620,13 @@ class UniversalCircuit : public Circuit
     SignatureVerifier signatureVerifier;
 
     // Transactions
+    unsigned int blockType;
     unsigned int numTransactions;
+    BlockLayout layout;
     std::vector<TransactionGadget> transactions;
+    // Constraints [txConstraints[j], txConstraints[j + 1]) belong to transaction j
+    std::vector<size_t> txConstraints;
+    PublicKeyRoots publicKeyRoots;
 
     // Update Protocol pool
     std::unique_ptr<UpdateAccountGadget> updateAccount_P;
@@ -1497,9 +1665,12 @@ class UniversalCircuit : public Circuit
     std::unique_ptr<ToBitsGadget> withdrawSize;
     UniversalCircuit( //
       ProtoboardT &pb,
+      unsigned int _blockType,
       const std::string &prefix)
         : Circuit(pb, prefix),
 
+          blockType(_blockType),
+
           publicData(pb, FMT(prefix, ".publicData")),
           constants(pb, FMT(prefix, ".constants")),
 
@@ -1536,6 +1707,7 @@ class UniversalCircuit : public Circuit
     void generateConstraints(unsigned int blockSize) override
     {
         this->numTransactions = blockSize;
+        this->layout = getBlockLayout(blockType, blockSize);
 
         constants.generate_r1cs_constraints();
 
@@ -1554,6 +1726,7 @@ class UniversalCircuit : public Circuit
 
         // Transactions
         transactions.reserve(numTransactions);
+        txConstraints.push_back(pb.num_constraints());
         for (size_t j = 0; j < numTransactions; j++)
         {
             txTypes.emplace_back(pb, NUM_BITS_TX_TYPE_FOR_SELECT, FMT(annotation_prefix, ".txTypes"));
@@ -1619,8 +1792,11 @@ class UniversalCircuit : public Circuit
               operatorAccountID.bits,
               (j == 0) ? constants._0 : transactions.back().tx.getOutput(TXV_NUM_CONDITIONAL_TXS),
               txTypes.back().packed,
-              std::string("tx_") + std::to_string(j));
-            transactions.back().generate_r1cs_constraints();
+              layout.isFull(j),
+              std::string("tx_") + std::to_string(j),
+              &publicKeyRoots);
+            ConstraintProfiler::generate(transactions.back(), layout.isFull(j) ? "transaction" : "lightTransaction");
+            txConstraints.push_back(pb.num_constraints());
         }
 
         depositSize.reset(new ToBitsGadget(pb, depositSizeAdd.back().result(), NUM_BITS_TX_SIZE, FMT(annotation_prefix, ".depositSize")));
@@ -1658,7 +1834,7 @@ class UniversalCircuit : public Circuit
            accountBefore_P.balancesRoot,
            accountBefore_P.storageRoot},
           FMT(annotation_prefix, ".updateAccount_P")));
-        updateAccount_P->generate_r1cs_constraints();
+        ConstraintProfiler::generate(*updateAccount_P, "updateAccount_P");
 
         // Update Operator
         updateAccount_O.reset(new UpdateAccountGadget(
@@ -1689,7 +1865,7 @@ class UniversalCircuit : public Circuit
            accountBefore_O.balancesRoot,
            accountBefore_O.storageRoot},
           FMT(annotation_prefix, ".updateAccount_O")));
-        updateAccount_O->generate_r1cs_constraints();
+        ConstraintProfiler::generate(*updateAccount_O, "updateAccount_O");
 
         // Num of conditional transactions
         numConditionalTransactions.reset(new ToBitsGadget(
@@ -1716,11 +1892,11 @@ class UniversalCircuit : public Circuit
             publicData.add(reverse(transactions[j].getPublicData()));
         }
         publicData.transform(start, numTransactions, TX_DATA_AVAILABILITY_SIZE * 8);
-        publicData.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(publicData);
 
         // Signature
-        hash.generate_r1cs_constraints();
-        signatureVerifier.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(hash);
+        PROFILE_CONSTRAINTS(signatureVerifier);
 
         // Check the new merkle root
         requireEqual(pb, updateAccount_O->result(), merkleRootAfter.packed, "newMerkleRoot");
@@ -1728,13 +1904,22 @@ class UniversalCircuit : public Circuit
         requireEqual(pb, updateAccount_O->assetResult(), merkleAssetRootAfter.packed, "newMerkleAssetRoot");
     }
 
-    bool generateWitness(const Block &block)
+    bool generateWitness(const Block &block) override
     {
         if (block.transactions.size() != numTransactions)
         {
-            std::cout << "Invalid number of transactions: " << block.transactions.size() << std::endl;
+            LOG(LogError, "Invalid number of transactions", block.transactions.size());
             return false;
         }
+        for (unsigned int i = 0; i < block.transactions.size(); i++)
+        {
+            const TransactionType type = TransactionType(UInt256(block.transactions[i].type).toUint64());
+            if (!layout.isFull(i) && !isLightTransactionType(type))
+            {
+                LOG(LogError, "Transaction type not supported by a light transaction slot", i);
+                return false;
+            }
+        }
 
         constants.generate_r1cs_witness();
 
@@ -1755,65 +1940,103 @@ class UniversalCircuit : public Circuit
         // Increase the nonce of the Operator
         nonce_after.generate_r1cs_witness();
 
-        // Transactions
+        // Transaction types, every other stage depends on them
         for (unsigned int i = 0; i < block.transactions.size(); i++)
         {
             pb.val(transactions[i].tx.getOutput(TXV_NUM_CONDITIONAL_TXS)) =
               block.transactions[i].witness.numConditionalTransactionsAfter;
-            
             txTypes[i].generate_r1cs_witness(pb, block.transactions[i].type);
+        }
 
-            isDeposit[i].generate_r1cs_witness();
-            isAccountUpdate[i].generate_r1cs_witness();
-            isWithdraw[i].generate_r1cs_witness();
-
-            isSpecialTransaction[i].generate_r1cs_witness();
-            isOtherTransaction[i].generate_r1cs_witness();
-
-            depositSizeIsZero[i].generate_r1cs_witness();
-            accountUpdateSizeIsZero[i].generate_r1cs_witness();
-            otherTransactionSizeIsZero[i].generate_r1cs_witness();
-            withdrawSizeIsZero[i].generate_r1cs_witness();
-
-            depositCondition[i].generate_r1cs_witness();
-            accountUpdateCondition[i].generate_r1cs_witness();
-
-            requireValidDeposit[i].generate_r1cs_witness();
-            requireValidAccountUpdate[i].generate_r1cs_witness();
-            requireValidOtherTransaction[i].generate_r1cs_witness();
-
-            depositSizeAdd[i].generate_r1cs_witness();
-            accountUpdateSizeAdd[i].generate_r1cs_witness();
-            otherTransactionSizeAdd[i].generate_r1cs_witness();
-            withdrawSizeAdd[i].generate_r1cs_witness();
+        // Every slot decompresses the (possibly dummy) public keys of its
+        // account update and app key update, batch the field operations for these.
+        std::vector<FieldT> publicKeyYs;
+        for (const UniversalTransaction &uTx : block.transactions)
+        {
+            publicKeyYs.push_back(uTx.accountUpdate.publicKeyY);
+            publicKeyYs.push_back(uTx.appKeyUpdate.appKeyPublicKeyY);
         }
-#ifdef MULTICORE
-#pragma omp parallel for
-#endif
+        publicKeyRoots.resolve(params, publicKeyYs);
+
+        // The transactions only share inputs that are already set above, so they
+        // can all be done in parallel, together with the operator/protocol pool
+        // updates and the transaction size checks. The public data needs the
+        // transactions and sizes, the block signature needs the public data.
+        TaskGraph graph;
+        std::vector<unsigned int> txTasks;
         for (unsigned int i = 0; i < block.transactions.size(); i++)
         {
-            std::cout << "--------------- tx: " << i << " ( " << block.transactions[i].type << " ) " << std::endl;
-            transactions[i].generate_r1cs_witness(block.transactions[i]);
+            const UniversalTransaction &uTx = block.transactions[i];
+            txTasks.push_back(graph.add(
+              "tx_" + std::to_string(i), getWitnessWeight(uTx.type), [this, &uTx, i]() {
+                  transactions[i].generate_r1cs_witness(uTx);
+              }));
         }
-        depositSize->generate_r1cs_witness();
-        accountUpdateSize->generate_r1cs_witness();
-        withdrawSize->generate_r1cs_witness();
+        unsigned int sizesTask = graph.add("sizes", 1, [this, &block]() {
+            for (unsigned int i = 0; i < block.transactions.size(); i++)
+            {
+                isDeposit[i].generate_r1cs_witness();
+                isAccountUpdate[i].generate_r1cs_witness();
+                isWithdraw[i].generate_r1cs_witness();
 
-        // Update Protocol pool
-        updateAccount_P->generate_r1cs_witness(block.accountUpdate_P);
+                isSpecialTransaction[i].generate_r1cs_witness();
+                isOtherTransaction[i].generate_r1cs_witness();
 
-        // Update Operator
-        updateAccount_O->generate_r1cs_witness(block.accountUpdate_O);
+                depositSizeIsZero[i].generate_r1cs_witness();
+                accountUpdateSizeIsZero[i].generate_r1cs_witness();
+                otherTransactionSizeIsZero[i].generate_r1cs_witness();
+                withdrawSizeIsZero[i].generate_r1cs_witness();
 
-        // Num of conditional transactions
-        numConditionalTransactions->generate_r1cs_witness_from_packed();
+                depositCondition[i].generate_r1cs_witness();
+                accountUpdateCondition[i].generate_r1cs_witness();
 
-        // Public data
-        publicData.generate_r1cs_witness();
+                requireValidDeposit[i].generate_r1cs_witness();
+                requireValidAccountUpdate[i].generate_r1cs_witness();
+                requireValidOtherTransaction[i].generate_r1cs_witness();
 
+                depositSizeAdd[i].generate_r1cs_witness();
+                accountUpdateSizeAdd[i].generate_r1cs_witness();
+                otherTransactionSizeAdd[i].generate_r1cs_witness();
+                withdrawSizeAdd[i].generate_r1cs_witness();
+            }
+            depositSize->generate_r1cs_witness();
+            accountUpdateSize->generate_r1cs_witness();
+            withdrawSize->generate_r1cs_witness();
+        });
+        // Update Protocol pool
+        unsigned int accountPTask = graph.add("updateAccount_P", 2, [this, &block]() {
+            updateAccount_P->generate_r1cs_witness(block.accountUpdate_P);
+        });
+        // Update Operator
+        graph.add(
+          "updateAccount_O",
+          2,
+          [this, &block]() { updateAccount_O->generate_r1cs_witness(block.accountUpdate_O); },
+          {accountPTask});
+        // Num of conditional transactions
+        unsigned int numConditionalTask = graph.add(
+          "numConditionalTransactions",
+          0,
+          [this]() { numConditionalTransactions->generate_r1cs_witness_from_packed(); },
+          {txTasks.back()});
+        // Public data
+        std::vector<unsigned int> publicDataDependencies = txTasks;
+        publicDataDependencies.push_back(sizesTask);
+        publicDataDependencies.push_back(numConditionalTask);
+        unsigned int publicDataTask = graph.add(
+          "publicData", 1, [this]() { publicData.generate_r1cs_witness(); }, publicDataDependencies);
         // Signature
-        hash.generate_r1cs_witness();
-        signatureVerifier.generate_r1cs_witness(block.signature);
+        graph.add(
+          "signature",
+          1,
+          [this, &block]() {
+              hash.generate_r1cs_witness();
+              signatureVerifier.generate_r1cs_witness(block.signature);
+          },
+          {publicDataTask});
+
+        graph.run();
+        LOG(LogInfo, "Witness", graph.getStats());
 
         return true;
     }
@@ -1825,7 +2048,7 @@ class UniversalCircuit : public Circuit
 
     unsigned int getBlockType() override
     {
-        return 0;
+        return blockType;
     }
 
     unsigned int getBlockSize() override
@@ -1838,6 +2061,17 @@ class UniversalCircuit : public Circuit
         std::cout << pb.num_constraints() << " constraints (" << (pb.num_constraints() / numTransactions) << "/tx)"
                   << ";num_variables:" << pb.num_variables() << ";num_inputs:" << pb.num_inputs() << std::endl;
     }
+
+    std::string describeConstraint(size_t index) override
+    {
+        if (index < txConstraints.front() || index >= txConstraints.back())
+        {
+            return "block";
+        }
+        unsigned int j = std::upper_bound(txConstraints.begin(), txConstraints.end(), index) - txConstraints.begin() - 1;
+        TransactionType type = TransactionType(UInt256(pb.val(txTypes[j].packed)).toUint64());
+        return "transaction " + std::to_string(j) + " (" + transactionTypeToString(type) + ")";
+    }
 };
 
 } // namespace Loopring
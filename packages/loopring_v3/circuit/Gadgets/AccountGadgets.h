@@ -6,6 +6,7 @@
 
 #include "../Utils/Constants.h"
 #include "../Utils/Data.h"
+#include "../Utils/CircuitStats.h"
 
 #include "MerkleTree.h"
 
@@ -36,17 +37,17 @@ struct AccountState
 
 static void printAccount(const ProtoboardT &pb, const AccountState &state)
 {
-    std::cout << "- owner: " << pb.val(state.owner) << std::endl;
-    std::cout << "- publicKeyX: " << pb.val(state.publicKeyX) << std::endl;
-    std::cout << "- publicKeyY: " << pb.val(state.publicKeyY) << std::endl;
-    std::cout << "- appKeyPublicKeyX: " << pb.val(state.appKeyPublicKeyX) << std::endl;
-    std::cout << "- appKeyPublicKeyY: " << pb.val(state.appKeyPublicKeyY) << std::endl;
-    std::cout << "- nonce: " << pb.val(state.nonce) << std::endl;
-    std::cout << "- disableAppKeySpotTrade: " << pb.val(state.disableAppKeySpotTrade) << std::endl;
-    std::cout << "- disableAppKeyWithdraw: " << pb.val(state.disableAppKeyWithdraw) << std::endl;
-    std::cout << "- disableAppKeyTransferToOther: " << pb.val(state.disableAppKeyTransferToOther) << std::endl;
-    std::cout << "- balancesRoot: " << pb.val(state.balancesRoot) << std::endl;
-    std::cout << "- storageRoot: " << pb.val(state.storageRoot) << std::endl;
+    LOG(LogError, "- owner", pb.val(state.owner));
+    LOG(LogError, "- publicKeyX", pb.val(state.publicKeyX));
+    LOG(LogError, "- publicKeyY", pb.val(state.publicKeyY));
+    LOG(LogError, "- appKeyPublicKeyX", pb.val(state.appKeyPublicKeyX));
+    LOG(LogError, "- appKeyPublicKeyY", pb.val(state.appKeyPublicKeyY));
+    LOG(LogError, "- nonce", pb.val(state.nonce));
+    LOG(LogError, "- disableAppKeySpotTrade", pb.val(state.disableAppKeySpotTrade));
+    LOG(LogError, "- disableAppKeyWithdraw", pb.val(state.disableAppKeyWithdraw));
+    LOG(LogError, "- disableAppKeyTransferToOther", pb.val(state.disableAppKeyTransferToOther));
+    LOG(LogError, "- balancesRoot", pb.val(state.balancesRoot));
+    LOG(LogError, "- storageRoot", pb.val(state.storageRoot));
 
 }
 
@@ -113,13 +114,14 @@ class UpdateAccountGadget : public GadgetT
     AccountState valuesBefore;
     AccountState valuesAfter;
 
+    // Shared by the account and asset trees
+    merkle_path_address_4 pathAddress;
+
     const VariableArrayT proof;
-    MerklePathCheckT proofVerifierBefore;
-    MerklePathT rootCalculatorAfter;
+    MerklePathUpdateT pathUpdate;
 
     const VariableArrayT assetProof;
-    MerklePathCheckT assetProofVerifierBefore;
-    MerklePathT assetRootCalculatorAfter;
+    MerklePathUpdateT assetPathUpdate;
 
     UpdateAccountGadget(
       ProtoboardT &pb,
@@ -185,42 +187,29 @@ class UpdateAccountGadget : public GadgetT
                after.balancesRoot}),
             FMT(prefix, ".assetLeafAfter")),
 
+          pathAddress(pb, TREE_DEPTH_ACCOUNTS, address, FMT(prefix, ".pathAddress")),
+
           proof(make_var_array(pb, TREE_DEPTH_ACCOUNTS * 3, FMT(prefix, ".proof"))),
-          proofVerifierBefore(
+          pathUpdate(
             pb,
-            TREE_DEPTH_ACCOUNTS,
-            address,
+            pathAddress,
             leafBefore.result(),
-            merkleRoot,
-            proof,
-            FMT(prefix, ".pathBefore")),
-          rootCalculatorAfter( //
-            pb,
-            TREE_DEPTH_ACCOUNTS,
-            address,
             leafAfter.result(),
+            merkleRoot,
             proof,
-            FMT(prefix, ".pathAfter")),
-          
+            FMT(prefix, ".pathUpdate")),
 
           assetProof(make_var_array(pb, TREE_DEPTH_ACCOUNTS * 3, FMT(prefix, ".assetProof"))),
-          assetProofVerifierBefore(
+          assetPathUpdate(
             pb,
-            TREE_DEPTH_ACCOUNTS,
-            address,
+            pathAddress,
             assetLeafBefore.result(),
-            merkleAssetRoot,
-            assetProof,
-            FMT(prefix, ".assetProofVerifierBefore")),
-          assetRootCalculatorAfter( //
-            pb,
-            TREE_DEPTH_ACCOUNTS,
-            address,
             assetLeafAfter.result(),
+            merkleAssetRoot,
             assetProof,
-            FMT(prefix, ".assetRootCalculatorAfter"))
+            FMT(prefix, ".assetPathUpdate"))
     {
-        std::cout << "in UpdateAccountGadget" << std::endl;
+        LOG(LogDebug, "in UpdateAccountGadget", "");
     }
 
     void generate_r1cs_witness(const AccountUpdate &update)
@@ -231,51 +220,49 @@ class UpdateAccountGadget : public GadgetT
         assetLeafBefore.generate_r1cs_witness();
         assetLeafAfter.generate_r1cs_witness();
 
+        pathAddress.generate_r1cs_witness();
+
         proof.fill_with_field_elements(pb, update.proof.data);
-        proofVerifierBefore.generate_r1cs_witness();
-        rootCalculatorAfter.generate_r1cs_witness();
+        pathUpdate.generate_r1cs_witness();
 
         assetProof.fill_with_field_elements(pb, update.assetProof.data);
-        assetProofVerifierBefore.generate_r1cs_witness();
-        assetRootCalculatorAfter.generate_r1cs_witness();
-        
-        if (pb.val(rootCalculatorAfter.result()) != update.rootAfter)
+        assetPathUpdate.generate_r1cs_witness();
+
+        if (pb.val(pathUpdate.result()) != update.rootAfter)
         {
             printAccount(pb, valuesBefore);
             printAccount(pb, valuesAfter);
-            ASSERT(pb.val(rootCalculatorAfter.result()) == update.rootAfter, annotation_prefix);
+            ASSERT(pb.val(pathUpdate.result()) == update.rootAfter, annotation_prefix);
         }
-        if (pb.val(assetRootCalculatorAfter.result()) != update.assetRootAfter)
+        if (pb.val(assetPathUpdate.result()) != update.assetRootAfter)
         {
             printAccount(pb, valuesBefore);
             printAccount(pb, valuesAfter);
-            ASSERT(pb.val(assetRootCalculatorAfter.result()) == update.assetRootAfter, annotation_prefix);
+            ASSERT(pb.val(assetPathUpdate.result()) == update.assetRootAfter, annotation_prefix);
         }
     }
 
     void generate_r1cs_constraints()
     {
-        leafBefore.generate_r1cs_constraints();
-        leafAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(leafBefore);
+        PROFILE_CONSTRAINTS(leafAfter);
 
-        assetLeafBefore.generate_r1cs_constraints();
-        assetLeafAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(assetLeafBefore);
+        PROFILE_CONSTRAINTS(assetLeafAfter);
 
-        proofVerifierBefore.generate_r1cs_constraints();
-        rootCalculatorAfter.generate_r1cs_constraints();
-
-        assetProofVerifierBefore.generate_r1cs_constraints();
-        assetRootCalculatorAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(pathAddress);
+        PROFILE_CONSTRAINTS(pathUpdate);
+        PROFILE_CONSTRAINTS(assetPathUpdate);
     }
 
     const VariableT &result() const
     {
-        return rootCalculatorAfter.result();
+        return pathUpdate.result();
     }
 
     const VariableT &assetResult() const
     {
-        return assetRootCalculatorAfter.result();
+        return assetPathUpdate.result();
     }
 };
 
@@ -286,7 +273,7 @@ struct BalanceState
 
 static void printBalance(const ProtoboardT &pb, const BalanceState &state)
 {
-    std::cout << "- balance: " << pb.val(state.balance) << std::endl;
+    LOG(LogError, "- balance", pb.val(state.balance));
 }
 
 class BalanceGadget : public GadgetT
@@ -320,9 +307,9 @@ class UpdateBalanceGadget : public GadgetT
     BalanceState valuesBefore;
     BalanceState valuesAfter;
 
+    merkle_path_address_4 pathAddress;
     const VariableArrayT proof;
-    MerklePathCheckT proofVerifierBefore;
-    MerklePathT rootCalculatorAfter;
+    MerklePathUpdateT pathUpdate;
 
     UpdateBalanceGadget(
       ProtoboardT &pb,
@@ -345,22 +332,16 @@ class UpdateBalanceGadget : public GadgetT
             var_array({after.balance}),
             FMT(prefix, ".leafAfter")),
 
+          pathAddress(pb, TREE_DEPTH_TOKENS, tokenID, FMT(prefix, ".pathAddress")),
           proof(make_var_array(pb, TREE_DEPTH_TOKENS * 3, FMT(prefix, ".proof"))),
-          proofVerifierBefore(
+          pathUpdate(
             pb,
-            TREE_DEPTH_TOKENS,
-            tokenID,
+            pathAddress,
             leafBefore.result(),
-            merkleRoot,
-            proof,
-            FMT(prefix, ".pathBefore")),
-          rootCalculatorAfter( //
-            pb,
-            TREE_DEPTH_TOKENS,
-            tokenID,
             leafAfter.result(),
+            merkleRoot,
             proof,
-            FMT(prefix, ".pathAfter"))
+            FMT(prefix, ".pathUpdate"))
     {
         LOG(LogDebug, "in UpdateBalanceGadget", "");
     }
@@ -370,31 +351,31 @@ class UpdateBalanceGadget : public GadgetT
         leafBefore.generate_r1cs_witness();
         leafAfter.generate_r1cs_witness();
 
+        pathAddress.generate_r1cs_witness();
         proof.fill_with_field_elements(pb, update.proof.data);
-        proofVerifierBefore.generate_r1cs_witness();
-        rootCalculatorAfter.generate_r1cs_witness();
- 
-        ASSERT(pb.val(proofVerifierBefore.m_expected_root) == update.rootBefore, annotation_prefix);
-        if (pb.val(rootCalculatorAfter.result()) != update.rootAfter)
+        pathUpdate.generate_r1cs_witness();
+
+        ASSERT(pb.val(pathUpdate.m_expected_root) == update.rootBefore, annotation_prefix);
+        if (pb.val(pathUpdate.result()) != update.rootAfter)
         {
             printBalance(pb, valuesBefore);
             printBalance(pb, valuesAfter);
-            ASSERT(pb.val(rootCalculatorAfter.result()) == update.rootAfter, annotation_prefix);
+            ASSERT(pb.val(pathUpdate.result()) == update.rootAfter, annotation_prefix);
         }
     }
 
     void generate_r1cs_constraints()
     {
-        leafBefore.generate_r1cs_constraints();
-        leafAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(leafBefore);
+        PROFILE_CONSTRAINTS(leafAfter);
 
-        proofVerifierBefore.generate_r1cs_constraints();
-        rootCalculatorAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(pathAddress);
+        PROFILE_CONSTRAINTS(pathUpdate);
     }
 
     const VariableT &result() const
     {
-        return rootCalculatorAfter.result();
+        return pathUpdate.result();
     }
 };
 // Calculcate the state of a user's open position
@@ -910,7 +910,7 @@ class AndGadget : public GadgetT
         // This can be done more efficiently but since we never have any long inputs, it is not needed
         if (inputs.size() > 3)
         {
-            std::cout << "[AndGadget] unexpected input length " << inputs.size() << std::endl;
+            LOG(LogError, "[AndGadget] unexpected input length", inputs.size());
         }
         pb.add_r1cs_constraint(ConstraintT(inputs[0], inputs[1], results[0]), FMT(annotation_prefix, ".A && B"));
         for (unsigned int i = 2; i < inputs.size(); i++)
@@ -962,7 +962,7 @@ class AndThreeGadget : public GadgetT
         // This can be done more efficiently but since we never have any long inputs, it is not needed
         if (inputs.size() > 3)
         {
-            std::cout << "[AndGadget] unexpected input length " << inputs.size() << std::endl;
+            LOG(LogError, "[AndGadget] unexpected input length", inputs.size());
         }
         pb.add_r1cs_constraint(ConstraintT(inputs[0], inputs[1], results[0]), FMT(annotation_prefix, ".A && B"));
         for (unsigned int i = 2; i < inputs.size(); i++)
@@ -1012,7 +1012,7 @@ class AndTwoGadget : public GadgetT
         // This can be done more efficiently but since we never have any long inputs, it is not needed
         if (inputs.size() > 3)
         {
-            std::cout << "[AndGadget] unexpected input length " << inputs.size() << std::endl;
+            LOG(LogError, "[AndGadget] unexpected input length", inputs.size());
         }
         pb.add_r1cs_constraint(ConstraintT(inputs[0], inputs[1], results[0]), FMT(annotation_prefix, ".A && B"));
         for (unsigned int i = 2; i < inputs.size(); i++)
@@ -1062,7 +1062,7 @@ class OrGadget : public GadgetT
     {
         if (inputs.size() > 3)
         {
-            std::cout << "[OrGadget] unexpected input length " << inputs.size() << std::endl;
+            LOG(LogError, "[OrGadget] unexpected input length", inputs.size());
         }
 
         pb.add_r1cs_constraint(
@@ -1119,7 +1119,7 @@ class OrThreeGadget : public GadgetT
     {
         if (inputs.size() > 3)
         {
-            std::cout << "[OrGadget] unexpected input length " << inputs.size() << std::endl;
+            LOG(LogError, "[OrGadget] unexpected input length", inputs.size());
         }
 
         pb.add_r1cs_constraint(
@@ -2039,8 +2039,8 @@ class MulDivGadget : public GadgetT
         product.generate_r1cs_witness();
         if (pb.val(denominator) != FieldT::zero())
         {
-            pb.val(quotient) = ethsnarks::FieldT(
-              (toBigInt(pb.val(product.result())) / toBigInt(pb.val(denominator))).to_string().c_str());
+            pb.val(quotient) =
+              (UInt256(pb.val(product.result())) / UInt256(pb.val(denominator))).toFieldElement();
         }
         else
         {
@@ -2457,9 +2457,9 @@ class PublicDataGadget : public GadgetT
         calculatedHash->generate_r1cs_witness_from_bits();
         pb.val(publicInput) = pb.val(calculatedHash->packed);
 
-        printBits("[ZKS]publicData: 0x", publicDataBits.get_bits(pb), false);
-        printBits("[ZKS]publicDataHash: 0x", hasher->result().bits.get_bits(pb));
-        print(pb, "[ZKS]publicInput", calculatedHash->packed);
+        LOG(LogDebug, "[ZKS]publicData", toHexString(publicDataBits.get_bits(pb)));
+        LOG(LogDebug, "[ZKS]publicDataHash", toHexString(hasher->result().bits.get_bits(pb)));
+        LOG(LogInfo, "[ZKS]publicInput", pb.val(publicInput));
     }
 
     void generate_r1cs_constraints()
@@ -2774,7 +2774,7 @@ class FloatFromBitsGadget : public GadgetT
         return f;
     }
 };
-// Checks 'type' is one of Constants.values - [0 - 10]
+// Checks 'type' is one of Constants.values - [0 - 10] (or one of a list of them)
 struct SelectorGadget : public GadgetT
 {
     const Constants &constants;
@@ -2793,18 +2793,39 @@ struct SelectorGadget : public GadgetT
         : GadgetT(pb, prefix), constants(_constants)
     {
 
-        std::cout << "in SelectorGadget: maxBits:" << maxBits << std::endl;
-        std::cout << "in SelectorGadget: constants.values.size():" << constants.values.size() << std::endl;
+        LOG(LogDebug, "in SelectorGadget: maxBits", maxBits);
+        LOG(LogDebug, "in SelectorGadget: constants.values.size()", constants.values.size());
         assert(maxBits <= constants.values.size());
         for (unsigned int i = 0; i < maxBits; i++)
         {
-            bits.emplace_back(pb, type, constants.values[i], FMT(annotation_prefix, ".bits"));
-            sum.emplace_back(
-              pb, (i == 0) ? constants._0 : sum.back().result(), bits.back().result(), FMT(annotation_prefix, ".sum"));
-            res.emplace_back(bits.back().result());
+            add(type, i);
+        }
+    }
+
+    // Only accepts the listed values, res[i] is set for constants.values[types[i]]
+    SelectorGadget(
+      ProtoboardT &pb,
+      const Constants &_constants,
+      const VariableT &type,
+      const std::vector<unsigned int> &types,
+      const std::string &prefix)
+        : GadgetT(pb, prefix), constants(_constants)
+    {
+        for (unsigned int value : types)
+        {
+            assert(value < constants.values.size());
+            add(type, value);
         }
     }
 
+    void add(const VariableT &type, unsigned int value)
+    {
+        bits.emplace_back(pb, type, constants.values[value], FMT(annotation_prefix, ".bits"));
+        sum.emplace_back(
+          pb, sum.empty() ? constants._0 : sum.back().result(), bits.back().result(), FMT(annotation_prefix, ".sum"));
+        res.emplace_back(bits.back().result());
+    }
+
     void generate_r1cs_witness()
     {
         for (unsigned int i = 0; i < bits.size(); i++)
@@ -2984,6 +3005,245 @@ class VectorArraySelectGadget : public GadgetT
     }
 };
 
+// Inner product of a one-hot selector (exactly one entry is 1, as proven by
+// SelectorGadget) with a list of values. Equal values are only multiplied once
+// and the most common value is used as the base:
+//   result = base + sum_k (selector entries of value k) * (value_k - base)
+// This costs a constraint for every distinct value other than the base, the
+// last product is part of the constraint on the result.
+class OneHotInnerProductGadget : public GadgetT
+{
+  public:
+    typedef libsnark::linear_combination<FieldT> LinearCombinationT;
+
+    unsigned int baseIndex;
+    LinearCombinationT base;
+    std::vector<LinearCombinationT> selected;
+    std::vector<LinearCombinationT> differences;
+    VariableArrayT products;
+
+    OneHotInnerProductGadget(
+      ProtoboardT &pb,
+      const VariableArrayT &selector,
+      const std::vector<LinearCombinationT> &values,
+      const std::string &prefix)
+        : GadgetT(pb, prefix)
+    {
+        assert(values.size() == selector.size());
+        std::vector<unsigned int> first;
+        std::vector<LinearCombinationT> groupSelected;
+        for (unsigned int i = 0; i < values.size(); i++)
+        {
+            unsigned int j = 0;
+            while (j < first.size() && !equal(values[first[j]], values[i]))
+            {
+                j++;
+            }
+            if (j == first.size())
+            {
+                first.push_back(i);
+                groupSelected.emplace_back(selector[i]);
+            }
+            else
+            {
+                groupSelected[j] = groupSelected[j] + selector[i];
+            }
+        }
+
+        unsigned int baseGroup = 0;
+        for (unsigned int j = 1; j < first.size(); j++)
+        {
+            if (groupSelected[j].getTerms().size() > groupSelected[baseGroup].getTerms().size())
+            {
+                baseGroup = j;
+            }
+        }
+        baseIndex = first[baseGroup];
+        base = values[baseIndex];
+        for (unsigned int j = 0; j < first.size(); j++)
+        {
+            if (j != baseGroup)
+            {
+                selected.push_back(groupSelected[j]);
+                differences.push_back(values[first[j]] - base);
+            }
+        }
+        for (unsigned int k = 1; k < selected.size(); k++)
+        {
+            products.emplace_back(make_variable(pb, FMT(prefix, ".products")));
+        }
+    }
+
+    // All values are equal, the result is the value at baseIndex
+    bool isBase() const
+    {
+        return selected.empty();
+    }
+
+    FieldT value() const
+    {
+        FieldT result = evaluate(base);
+        for (unsigned int k = 0; k < selected.size(); k++)
+        {
+            result += evaluate(selected[k]) * evaluate(differences[k]);
+        }
+        return result;
+    }
+
+    void generate_r1cs_witness()
+    {
+        for (unsigned int k = 0; k < products.size(); k++)
+        {
+            pb.val(products[k]) = evaluate(selected[k]) * evaluate(differences[k]);
+        }
+    }
+
+    // Constrains `result` to the inner product, only needed when !isBase()
+    void generate_r1cs_constraints(const LinearCombinationT &result)
+    {
+        assert(!isBase());
+        LinearCombinationT remaining = result - base;
+        for (unsigned int k = 0; k < products.size(); k++)
+        {
+            pb.add_r1cs_constraint(
+              ConstraintT(selected[k], differences[k], products[k]), FMT(annotation_prefix, ".products"));
+            remaining = remaining - products[k];
+        }
+        pb.add_r1cs_constraint(
+          ConstraintT(selected.back(), differences.back(), remaining), FMT(annotation_prefix, ".result"));
+    }
+
+  private:
+    static bool equal(const LinearCombinationT &a, const LinearCombinationT &b)
+    {
+        const auto &termsA = a.getTerms();
+        const auto &termsB = b.getTerms();
+        if (termsA.size() != termsB.size())
+        {
+            return false;
+        }
+        for (unsigned int i = 0; i < termsA.size(); i++)
+        {
+            if (termsA[i].index != termsB[i].index || termsA[i].coeff != termsB[i].coeff)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FieldT evaluate(const LinearCombinationT &lc) const
+    {
+        FieldT result = FieldT::zero();
+        for (const auto &term : lc.getTerms())
+        {
+            const FieldT &coeff = term.coeff;
+            result += (term.index == 0) ? coeff : coeff * pb.val(VariableT(term.index));
+        }
+        return result;
+    }
+};
+
+// SelectGadget for a one-hot selector
+class OneHotSelectGadget : public GadgetT
+{
+  public:
+    OneHotInnerProductGadget innerProduct;
+    VariableT selected;
+
+    OneHotSelectGadget(
+      ProtoboardT &pb,
+      const Constants &_constants,
+      const VariableArrayT &selector,
+      const std::vector<VariableT> &values,
+      const std::string &prefix)
+        : GadgetT(pb, prefix),
+
+          innerProduct(
+            pb,
+            selector,
+            std::vector<OneHotInnerProductGadget::LinearCombinationT>(values.begin(), values.end()),
+            FMT(prefix, ".innerProduct")),
+          selected(
+            innerProduct.isBase() ? values[innerProduct.baseIndex] : make_variable(pb, FMT(prefix, ".selected")))
+    {
+    }
+
+    void generate_r1cs_witness()
+    {
+        innerProduct.generate_r1cs_witness();
+        if (!innerProduct.isBase())
+        {
+            pb.val(selected) = innerProduct.value();
+        }
+    }
+
+    void generate_r1cs_constraints()
+    {
+        if (!innerProduct.isBase())
+        {
+            innerProduct.generate_r1cs_constraints(selected);
+        }
+    }
+
+    const VariableT &result() const
+    {
+        return selected;
+    }
+};
+
+// ArraySelectGadget for a one-hot selector
+class OneHotArraySelectGadget : public GadgetT
+{
+  public:
+    std::vector<OneHotSelectGadget> results;
+    VariableArrayT res;
+
+    OneHotArraySelectGadget(
+      ProtoboardT &pb,
+      const Constants &_constants,
+      const VariableArrayT &selector,
+      const std::vector<VariableArrayT> &values,
+      const std::string &prefix)
+        : GadgetT(pb, prefix)
+    {
+        assert(values.size() == selector.size());
+        results.reserve(values[0].size());
+        for (unsigned int i = 0; i < values[0].size(); i++)
+        {
+            std::vector<VariableT> elements;
+            for (unsigned int j = 0; j < values.size(); j++)
+            {
+                assert(values[j].size() == values[0].size());
+                elements.push_back(values[j][i]);
+            }
+            results.emplace_back(pb, _constants, selector, elements, FMT(prefix, ".results"));
+            res.emplace_back(results.back().result());
+        }
+    }
+
+    void generate_r1cs_witness()
+    {
+        for (unsigned int i = 0; i < results.size(); i++)
+        {
+            results[i].generate_r1cs_witness();
+        }
+    }
+
+    void generate_r1cs_constraints()
+    {
+        for (unsigned int i = 0; i < results.size(); i++)
+        {
+            results[i].generate_r1cs_constraints();
+        }
+    }
+
+    const VariableArrayT &result() const
+    {
+        return res;
+    }
+};
+
 // Checks 'type' is one of value array - [n - m]
 // The return value exists in this case: 0, 1, 1, 1
 // That is, there must be only one match
@@ -206,6 +206,284 @@ template <typename HashT> class merkle_path_authenticator_4 : public merkle_path
     }
 };
 
+// The position bits of the nodes on a Merkle path. Shared by all paths over
+// the same address (e.g. the account and asset trees).
+class merkle_path_address_4 : public GadgetT
+{
+  public:
+    VariableArrayT m_bits;
+    std::vector<AndGadget> m_bit0_and_bit1;
+
+    // in_address_bits: {0..2}[in_depth*2]
+    merkle_path_address_4(
+      ProtoboardT &in_pb,
+      const size_t in_depth,
+      const VariableArrayT &in_address_bits,
+      const std::string &in_annotation_prefix)
+        : GadgetT(in_pb, in_annotation_prefix), m_bits(in_address_bits)
+    {
+        assert(in_depth > 0);
+        assert(in_address_bits.size() == in_depth * 2);
+
+        m_bit0_and_bit1.reserve(in_depth);
+        for (size_t i = 0; i < in_depth; i++)
+        {
+            m_bit0_and_bit1.emplace_back(
+              in_pb,
+              std::vector<VariableT>{m_bits[i * 2 + 0], m_bits[i * 2 + 1]},
+              FMT(this->annotation_prefix, ".bit0_and_bit1[%zu]", i));
+        }
+    }
+
+    size_t depth() const
+    {
+        return m_bit0_and_bit1.size();
+    }
+
+    // 1 if the node on the path is child `index` at `level`, else 0
+    libsnark::linear_combination<FieldT> is_child(size_t level, unsigned int index) const
+    {
+        const VariableT &bit0 = m_bits[level * 2 + 0];
+        const VariableT &bit1 = m_bits[level * 2 + 1];
+        const VariableT &bit0_and_bit1 = m_bit0_and_bit1[level].result();
+        switch (index)
+        {
+            case 0:
+                return 1 - bit0 - bit1 + bit0_and_bit1;
+            case 1:
+                return bit0 - bit0_and_bit1;
+            case 2:
+                return bit1 - bit0_and_bit1;
+            default:
+                return bit0_and_bit1;
+        }
+    }
+
+    unsigned int position(size_t level) const
+    {
+        return (pb.val(m_bits[level * 2 + 0]) == FieldT::one() ? 1 : 0) +
+               (pb.val(m_bits[level * 2 + 1]) == FieldT::one() ? 2 : 0);
+    }
+
+    void generate_r1cs_constraints()
+    {
+        for (size_t i = 0; i < m_bit0_and_bit1.size(); i++)
+        {
+            m_bit0_and_bit1[i].generate_r1cs_constraints();
+        }
+    }
+
+    void generate_r1cs_witness()
+    {
+        for (size_t i = 0; i < m_bit0_and_bit1.size(); i++)
+        {
+            m_bit0_and_bit1[i].generate_r1cs_witness();
+        }
+    }
+};
+
+// The children not on the path for all paths over the same address and proof
+// (e.g. the leaf before and after an update). Child j of a level is the node on
+// the path when it is at position j, else sibling j:
+//   [y0, bit1 ? y1 : y0, bit1 ? y2 : y1, y2]
+// The siblings don't depend on the node on the path so they are only selected once.
+class merkle_path_siblings_4 : public GadgetT
+{
+  public:
+    merkle_path_address_4 m_address;
+    VariableArrayT m_path;
+    std::vector<TernaryGadget> m_sibling1;
+    std::vector<TernaryGadget> m_sibling2;
+
+    // in_path: The Merkle inclusion proof values
+    merkle_path_siblings_4(
+      ProtoboardT &in_pb,
+      const merkle_path_address_4 &in_address,
+      const VariableArrayT &in_path,
+      const std::string &in_annotation_prefix)
+        : GadgetT(in_pb, in_annotation_prefix), m_address(in_address), m_path(in_path)
+    {
+        assert(in_path.size() == m_address.depth() * 3);
+
+        m_sibling1.reserve(m_address.depth());
+        m_sibling2.reserve(m_address.depth());
+        for (size_t i = 0; i < m_address.depth(); i++)
+        {
+            const VariableT &bit1 = m_address.m_bits[i * 2 + 1];
+            m_sibling1.emplace_back(
+              in_pb, bit1, m_path[i * 3 + 1], m_path[i * 3 + 0], FMT(this->annotation_prefix, ".sibling1[%zu]", i));
+            m_sibling2.emplace_back(
+              in_pb, bit1, m_path[i * 3 + 2], m_path[i * 3 + 1], FMT(this->annotation_prefix, ".sibling2[%zu]", i));
+        }
+    }
+
+    const VariableT &sibling(size_t level, unsigned int index) const
+    {
+        switch (index)
+        {
+            case 0:
+                return m_path[level * 3 + 0];
+            case 1:
+                return m_sibling1[level].result();
+            case 2:
+                return m_sibling2[level].result();
+            default:
+                return m_path[level * 3 + 2];
+        }
+    }
+
+    void generate_r1cs_constraints()
+    {
+        for (size_t i = 0; i < m_sibling1.size(); i++)
+        {
+            m_sibling1[i].generate_r1cs_constraints(false);
+            m_sibling2[i].generate_r1cs_constraints(false);
+        }
+    }
+
+    void generate_r1cs_witness()
+    {
+        for (size_t i = 0; i < m_sibling1.size(); i++)
+        {
+            m_sibling1[i].generate_r1cs_witness();
+            m_sibling2[i].generate_r1cs_witness();
+        }
+    }
+};
+
+// merkle_path_compute_4 with the address and siblings selected outside, every
+// level only costs a constraint per child:
+//   child_j = sibling_j + is_child_j * (node - sibling_j)
+// Copies the address and siblings, these need to be generated separately.
+template <typename HashT> class merkle_path_compute_shared_4 : public GadgetT
+{
+  public:
+    merkle_path_siblings_4 m_siblings;
+    VariableT m_leaf;
+    std::vector<VariableArrayT> m_children;
+    std::vector<HashT> m_hashers;
+
+    // in_leaf: The hashed leaf data
+    merkle_path_compute_shared_4(
+      ProtoboardT &in_pb,
+      const merkle_path_siblings_4 &in_siblings,
+      const VariableT &in_leaf,
+      const std::string &in_annotation_prefix)
+        : GadgetT(in_pb, in_annotation_prefix), m_siblings(in_siblings), m_leaf(in_leaf)
+    {
+        const size_t depth = m_siblings.m_address.depth();
+        m_children.reserve(depth);
+        m_hashers.reserve(depth);
+        for (size_t i = 0; i < depth; i++)
+        {
+            m_children.emplace_back(make_var_array(in_pb, 4, FMT(this->annotation_prefix, ".children[%zu]", i)));
+            m_hashers.emplace_back(in_pb, m_children[i], FMT(this->annotation_prefix, ".hasher[%zu]", i));
+        }
+    }
+
+    const VariableT &node(size_t level) const
+    {
+        return (level == 0) ? m_leaf : m_hashers[level - 1].result();
+    }
+
+    const VariableT &result() const
+    {
+        assert(m_hashers.size() > 0);
+        return m_hashers.back().result();
+    }
+
+    void generate_r1cs_constraints()
+    {
+        for (size_t i = 0; i < m_hashers.size(); i++)
+        {
+            for (unsigned int j = 0; j < 4; j++)
+            {
+                const VariableT &sibling = m_siblings.sibling(i, j);
+                this->pb.add_r1cs_constraint(
+                  ConstraintT(m_siblings.m_address.is_child(i, j), node(i) - sibling, m_children[i][j] - sibling),
+                  FMT(this->annotation_prefix, ".children[%zu]", i));
+            }
+            m_hashers[i].generate_r1cs_constraints();
+        }
+    }
+
+    void generate_r1cs_witness()
+    {
+        for (size_t i = 0; i < m_hashers.size(); i++)
+        {
+            const unsigned int position = m_siblings.m_address.position(i);
+            for (unsigned int j = 0; j < 4; j++)
+            {
+                this->pb.val(m_children[i][j]) =
+                  this->pb.val((j == position) ? node(i) : m_siblings.sibling(i, j));
+            }
+            m_hashers[i].generate_r1cs_witness();
+        }
+    }
+};
+
+/**
+ * Verifies the leaf before an update and calculates the root after the update,
+ * both paths share the address and the proof.
+ */
+template <typename HashT> class merkle_path_update_4 : public GadgetT
+{
+  public:
+    merkle_path_siblings_4 m_siblings;
+    merkle_path_compute_shared_4<HashT> m_path_before;
+    merkle_path_compute_shared_4<HashT> m_path_after;
+    const VariableT m_expected_root;
+
+    // in_address: The address of both leafs, generated outside
+    // in_leaf_before, in_leaf_after: The hashed leaf data before and after
+    // in_expected_root: The expected Merkle root value before
+    // in_path: The Merkle inclusion proof values
+    merkle_path_update_4(
+      ProtoboardT &in_pb,
+      const merkle_path_address_4 &in_address,
+      const VariableT &in_leaf_before,
+      const VariableT &in_leaf_after,
+      const VariableT &in_expected_root,
+      const VariableArrayT &in_path,
+      const std::string &in_annotation_prefix)
+        : GadgetT(in_pb, in_annotation_prefix),
+          m_siblings(in_pb, in_address, in_path, FMT(in_annotation_prefix, ".siblings")),
+          m_path_before(in_pb, m_siblings, in_leaf_before, FMT(in_annotation_prefix, ".pathBefore")),
+          m_path_after(in_pb, m_siblings, in_leaf_after, FMT(in_annotation_prefix, ".pathAfter")),
+          m_expected_root(in_expected_root)
+    {
+    }
+
+    bool is_valid() const
+    {
+        return this->pb.val(m_path_before.result()) == this->pb.val(m_expected_root);
+    }
+
+    const VariableT &result() const
+    {
+        return m_path_after.result();
+    }
+
+    void generate_r1cs_constraints()
+    {
+        m_siblings.generate_r1cs_constraints();
+        m_path_before.generate_r1cs_constraints();
+        m_path_after.generate_r1cs_constraints();
+
+        // Ensure root matches calculated path hash
+        this->pb.add_r1cs_constraint(
+          ConstraintT(m_path_before.result(), 1, m_expected_root),
+          FMT(this->annotation_prefix, ".expected_root authenticator"));
+    }
+
+    void generate_r1cs_witness()
+    {
+        m_siblings.generate_r1cs_witness();
+        m_path_before.generate_r1cs_witness();
+        m_path_after.generate_r1cs_witness();
+    }
+};
+
 // Same parameters for ease of implementation in EVM
 using HashMerkleTree = Poseidon_4;
 using HashAccountLeaf = Poseidon_11;
@@ -217,6 +495,7 @@ using HashAutoMarketStorageLeaf = Poseidon_4_<4>;
 
 using MerklePathCheckT = merkle_path_authenticator_4<HashMerkleTree>;
 using MerklePathT = merkle_path_compute_4<HashMerkleTree>;
+using MerklePathUpdateT = merkle_path_update_4<HashMerkleTree>;
 
 } // namespace Loopring
 
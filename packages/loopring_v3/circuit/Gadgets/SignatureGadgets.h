@@ -5,6 +5,8 @@
 #define _SIGNATUREGADGETS_H_
 
 #include "../Utils/Constants.h"
+#include "../Utils/FieldBatch.h"
+#include "../Utils/UInt256.h"
 
 #include "ethsnarks.hpp"
 #include "utils.hpp"
@@ -13,12 +15,79 @@
 #include "gadgets/subadd.hpp"
 #include "gadgets/poseidon.hpp"
 
+#include <map>
+
 using namespace ethsnarks;
 using namespace jubjub;
 
 namespace Loopring
 {
 
+// The inverse and square root CompressPublicKey needs for the public keys of a
+// whole block, resolved up front with a single batched inversion and a
+// parallel square root pass.
+class PublicKeyRoots
+{
+  public:
+    struct Roots
+    {
+        FieldT irhs;
+        FieldT rootX;
+    };
+
+    void resolve(const Params &params, const std::vector<FieldT> &ys)
+    {
+        roots.clear();
+        std::vector<FieldT> uniqueYs;
+        for (const FieldT &y : ys)
+        {
+            if (roots.emplace(UInt256(y), Roots()).second)
+            {
+                uniqueYs.push_back(y);
+            }
+        }
+
+        // xx = (y^2 - 1) / (d * y^2 - a)
+        std::vector<FieldT> lhs(uniqueYs.size());
+        std::vector<FieldT> irhs(uniqueYs.size());
+        for (unsigned int i = 0; i < uniqueYs.size(); i++)
+        {
+            FieldT yy = uniqueYs[i].squared();
+            lhs[i] = yy - FieldT::one();
+            irhs[i] = params.d * yy - params.a;
+        }
+        batchInverse(irhs);
+        std::vector<FieldT> rootX(uniqueYs.size());
+        for (unsigned int i = 0; i < uniqueYs.size(); i++)
+        {
+            rootX[i] = lhs[i] * irhs[i];
+        }
+        batchSqrt(rootX);
+
+        for (unsigned int i = 0; i < uniqueYs.size(); i++)
+        {
+            Roots &entry = roots[UInt256(uniqueYs[i])];
+            entry.irhs = irhs[i];
+            entry.rootX = rootX[i];
+        }
+    }
+
+    // nullptr if y wasn't resolved
+    const Roots *find(const FieldT &y) const
+    {
+        auto it = roots.find(UInt256(y));
+        return (it != roots.end()) ? &it->second : nullptr;
+    }
+
+    unsigned int size() const
+    {
+        return roots.size();
+    }
+
+  private:
+    std::map<UInt256, Roots> roots;
+};
+
 // Compresses the public key to 32 bytes. The public key is compressed and then fully decompressed to verify
 // that the decompression can be done successfully in a deterministic way. Because the code depends on a square root
 // it would be possible for different implementations to give inconsistent results if not correctly implemented
@@ -37,6 +106,7 @@ class CompressPublicKey : public GadgetT
     const Params &params;
     const Constants &constants;
     const VariableT &y;
+    const PublicKeyRoots *publicKeyRoots;
 
     // Reconstruct sqrt(xx)
     VariableT yy;
@@ -70,12 +140,14 @@ class CompressPublicKey : public GadgetT
       const Constants &_constants,
       const VariableT &_x,
       const VariableT &_y,
-      const std::string &prefix)
+      const std::string &prefix,
+      const PublicKeyRoots *_publicKeyRoots = nullptr)
         : GadgetT(pb, prefix),
 
           params(_params),
           constants(_constants),
           y(_y),
+          publicKeyRoots(_publicKeyRoots),
 
           // Reconstruct sqrt(xx)
           yy(make_variable(pb, FMT(prefix, ".yy"))),
@@ -114,9 +186,10 @@ class CompressPublicKey : public GadgetT
         pb.val(yy) = pb.val(y).squared();
         pb.val(lhs) = pb.val(yy) - 1;
         pb.val(rhs) = params.d * pb.val(yy) - params.a;
-        pb.val(irhs) = pb.val(rhs).inverse();
+        const PublicKeyRoots::Roots *roots = publicKeyRoots ? publicKeyRoots->find(pb.val(y)) : nullptr;
+        pb.val(irhs) = roots ? roots->irhs : pb.val(rhs).inverse();
         pb.val(xx) = pb.val(lhs) * pb.val(irhs);
-        pb.val(rootX) = pb.val(xx).sqrt();
+        pb.val(rootX) = roots ? roots->rootX : pb.val(xx).sqrt();
 
         // Reconstruct x
         negRootX.generate_r1cs_witness();
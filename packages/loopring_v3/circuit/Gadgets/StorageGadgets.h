@@ -6,6 +6,7 @@
 
 #include "../Utils/Constants.h"
 #include "../Utils/Data.h"
+#include "../Utils/CircuitStats.h"
 
 #include "MerkleTree.h"
 
@@ -30,13 +31,13 @@ struct StorageState
 
 static void printStorage(const ProtoboardT &pb, const StorageState &state)
 {
-    std::cout << "- tokenSID: " << pb.val(state.tokenSID) << std::endl;
-    std::cout << "- tokenBID: " << pb.val(state.tokenBID) << std::endl;
-    std::cout << "- data: " << pb.val(state.data) << std::endl;
-    std::cout << "- storageID: " << pb.val(state.storageID) << std::endl;
-    std::cout << "- gasFee: " << pb.val(state.gasFee) << std::endl;
-    std::cout << "- cancelled: " << pb.val(state.cancelled) << std::endl;
-    std::cout << "- forward: " << pb.val(state.forward) << std::endl;
+    LOG(LogError, "- tokenSID", pb.val(state.tokenSID));
+    LOG(LogError, "- tokenBID", pb.val(state.tokenBID));
+    LOG(LogError, "- data", pb.val(state.data));
+    LOG(LogError, "- storageID", pb.val(state.storageID));
+    LOG(LogError, "- gasFee", pb.val(state.gasFee));
+    LOG(LogError, "- cancelled", pb.val(state.cancelled));
+    LOG(LogError, "- forward", pb.val(state.forward));
 }
 
 class StorageGadget : public GadgetT
@@ -85,9 +86,9 @@ class UpdateStorageGadget : public GadgetT
     StorageState valuesBefore;
     StorageState valuesAfter;
 
+    merkle_path_address_4 pathAddress;
     const VariableArrayT proof;
-    MerklePathCheckT proofVerifierBefore;
-    MerklePathT rootCalculatorAfter;
+    MerklePathUpdateT pathUpdate;
 
     UpdateStorageGadget(
       ProtoboardT &pb,
@@ -108,16 +109,16 @@ class UpdateStorageGadget : public GadgetT
           var_array({after.tokenSID, after.tokenBID, after.data, after.storageID, after.gasFee, after.cancelled, after.forward}), 
           FMT(prefix, ".leafAfter")),
 
+          pathAddress(pb, TREE_DEPTH_STORAGE, slotID, FMT(prefix, ".pathAddress")),
           proof(make_var_array(pb, TREE_DEPTH_STORAGE * 3, FMT(prefix, ".proof"))),
-          proofVerifierBefore(
+          pathUpdate(
             pb,
-            TREE_DEPTH_STORAGE,
-            slotID,
+            pathAddress,
             leafBefore.result(),
+            leafAfter.result(),
             merkleRoot,
             proof,
-            FMT(prefix, ".pathBefore")),
-          rootCalculatorAfter(pb, TREE_DEPTH_STORAGE, slotID, leafAfter.result(), proof, FMT(prefix, ".pathAfter"))
+            FMT(prefix, ".pathUpdate"))
     {
     }
 
@@ -126,31 +127,31 @@ class UpdateStorageGadget : public GadgetT
         leafBefore.generate_r1cs_witness();
         leafAfter.generate_r1cs_witness();
 
+        pathAddress.generate_r1cs_witness();
         proof.fill_with_field_elements(pb, update.proof.data);
-        proofVerifierBefore.generate_r1cs_witness();
-        rootCalculatorAfter.generate_r1cs_witness();
+        pathUpdate.generate_r1cs_witness();
 
-        ASSERT(pb.val(proofVerifierBefore.m_expected_root) == update.rootBefore, annotation_prefix);
-        if (pb.val(rootCalculatorAfter.result()) != update.rootAfter)
+        ASSERT(pb.val(pathUpdate.m_expected_root) == update.rootBefore, annotation_prefix);
+        if (pb.val(pathUpdate.result()) != update.rootAfter)
         {
             printStorage(pb, valuesBefore);
             printStorage(pb, valuesAfter);
-            ASSERT(pb.val(rootCalculatorAfter.result()) == update.rootAfter, annotation_prefix);
+            ASSERT(pb.val(pathUpdate.result()) == update.rootAfter, annotation_prefix);
         }
     }
 
     void generate_r1cs_constraints()
     {
-        leafBefore.generate_r1cs_constraints();
-        leafAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(leafBefore);
+        PROFILE_CONSTRAINTS(leafAfter);
 
-        proofVerifierBefore.generate_r1cs_constraints();
-        rootCalculatorAfter.generate_r1cs_constraints();
+        PROFILE_CONSTRAINTS(pathAddress);
+        PROFILE_CONSTRAINTS(pathUpdate);
     }
 
     const VariableT &result() const
     {
-        return rootCalculatorAfter.result();
+        return pathUpdate.result();
     }
 };
 
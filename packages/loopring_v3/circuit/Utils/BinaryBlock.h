@@ -0,0 +1,578 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _BINARYBLOCK_H_
+#define _BINARYBLOCK_H_
+
+#include "Data.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary block format, a faster to load alternative to block.json.
+//
+// The file contains the block after parsing, so including all dummy data
+// that is filled in for unused transaction types. All values are little-endian:
+// - BinaryBlockHeader
+// - field elements: the canonical (non-Montgomery) value, num_limbs * 8 bytes
+// - arrays (Merkle proofs, transactions, ...): uint32 length followed by the elements
+// - everything else: its members in declaration order (see the serialize functions below)
+
+namespace Loopring
+{
+
+static const char BINARY_BLOCK_MAGIC[8] = {'D', 'G', 'B', 'L', 'O', 'C', 'K', '\0'};
+static const uint32_t BINARY_BLOCK_VERSION = 1;
+
+struct BinaryBlockHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t fieldSize;
+    uint32_t blockType;
+    uint32_t blockSize;
+};
+
+static const size_t BINARY_FIELD_SIZE = ethsnarks::FieldT::num_limbs * sizeof(mp_limb_t);
+
+static BinaryBlockHeader getBinaryBlockHeader(unsigned int blockType, unsigned int blockSize)
+{
+    BinaryBlockHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_BLOCK_MAGIC, sizeof(header.magic));
+    header.version = BINARY_BLOCK_VERSION;
+    header.fieldSize = BINARY_FIELD_SIZE;
+    header.blockType = blockType;
+    header.blockSize = blockSize;
+    return header;
+}
+
+class BinaryBlockWriter
+{
+  public:
+    std::vector<uint8_t> data;
+
+    void writeBytes(const void *src, size_t size)
+    {
+        const uint8_t *bytes = (const uint8_t *)src;
+        data.insert(data.end(), bytes, bytes + size);
+    }
+
+    void operator()(const ethsnarks::FieldT &value)
+    {
+        const auto bigint = value.as_bigint();
+        writeBytes(bigint.data, BINARY_FIELD_SIZE);
+    }
+
+    void operator()(const ethsnarks::jubjub::EdwardsPoint &point)
+    {
+        (*this)(point.x);
+        (*this)(point.y);
+    }
+
+    template <typename T> void operator()(const std::vector<T> &values)
+    {
+        uint32_t size = values.size();
+        writeBytes(&size, sizeof(size));
+        for (const T &value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+    template <typename T> void operator()(const T &value)
+    {
+        // serialize only reads the members when writing
+        serialize(*this, const_cast<T &>(value));
+    }
+};
+
+// Reads the block straight out of the (mapped) file data
+class BinaryBlockReader
+{
+  public:
+    BinaryBlockReader(const uint8_t *_data, size_t _size) : data(_data), end(_data + _size), error(false)
+    {
+    }
+
+    bool good() const
+    {
+        return !error;
+    }
+
+    const uint8_t *take(size_t size)
+    {
+        if (error || size > size_t(end - data))
+        {
+            error = true;
+            return nullptr;
+        }
+        const uint8_t *ptr = data;
+        data += size;
+        return ptr;
+    }
+
+    void operator()(ethsnarks::FieldT &value)
+    {
+        const uint8_t *src = take(BINARY_FIELD_SIZE);
+        if (src != nullptr)
+        {
+            libff::bigint<ethsnarks::FieldT::num_limbs> bigint;
+            memcpy(bigint.data, src, BINARY_FIELD_SIZE);
+            value = ethsnarks::FieldT(bigint);
+        }
+    }
+
+    void operator()(ethsnarks::jubjub::EdwardsPoint &point)
+    {
+        (*this)(point.x);
+        (*this)(point.y);
+    }
+
+    template <typename T> void operator()(std::vector<T> &values)
+    {
+        uint32_t size = 0;
+        const uint8_t *src = take(sizeof(size));
+        if (src == nullptr)
+        {
+            return;
+        }
+        memcpy(&size, src, sizeof(size));
+        // Every element takes at least a byte, don't trust the length blindly
+        if (size > size_t(end - data))
+        {
+            error = true;
+            return;
+        }
+        values.resize(size);
+        for (uint32_t i = 0; i < size && !error; i++)
+        {
+            (*this)(values[i]);
+        }
+    }
+
+    template <typename T> void operator()(T &value)
+    {
+        serialize(*this, value);
+    }
+
+  private:
+    const uint8_t *data;
+    const uint8_t *end;
+    bool error;
+};
+
+template <typename Archive> void serialize(Archive &ar, Proof &proof)
+{
+    ar(proof.data);
+}
+
+template <typename Archive> void serialize(Archive &ar, StorageLeaf &leaf)
+{
+    ar(leaf.tokenSID);
+    ar(leaf.tokenBID);
+    ar(leaf.data);
+    ar(leaf.storageID);
+    ar(leaf.gasFee);
+    ar(leaf.cancelled);
+    ar(leaf.forward);
+}
+
+template <typename Archive> void serialize(Archive &ar, BalanceLeaf &leaf)
+{
+    ar(leaf.balance);
+}
+
+template <typename Archive> void serialize(Archive &ar, AccountLeaf &account)
+{
+    ar(account.owner);
+    ar(account.publicKey);
+    ar(account.appKeyPublicKey);
+    ar(account.nonce);
+    ar(account.disableAppKeySpotTrade);
+    ar(account.disableAppKeyWithdraw);
+    ar(account.disableAppKeyTransferToOther);
+    ar(account.balancesRoot);
+    ar(account.storageRoot);
+}
+
+template <typename Archive> void serialize(Archive &ar, BalanceUpdate &balanceUpdate)
+{
+    ar(balanceUpdate.tokenID);
+    ar(balanceUpdate.proof);
+    ar(balanceUpdate.rootBefore);
+    ar(balanceUpdate.rootAfter);
+    ar(balanceUpdate.before);
+    ar(balanceUpdate.after);
+}
+
+template <typename Archive> void serialize(Archive &ar, StorageUpdate &storageUpdate)
+{
+    ar(storageUpdate.storageID);
+    ar(storageUpdate.proof);
+    ar(storageUpdate.rootBefore);
+    ar(storageUpdate.rootAfter);
+    ar(storageUpdate.before);
+    ar(storageUpdate.after);
+}
+
+template <typename Archive> void serialize(Archive &ar, AccountUpdate &accountUpdate)
+{
+    ar(accountUpdate.accountID);
+    ar(accountUpdate.proof);
+    ar(accountUpdate.assetProof);
+    ar(accountUpdate.rootBefore);
+    ar(accountUpdate.rootAfter);
+    ar(accountUpdate.assetRootBefore);
+    ar(accountUpdate.assetRootAfter);
+    ar(accountUpdate.before);
+    ar(accountUpdate.after);
+}
+
+template <typename Archive> void serialize(Archive &ar, Signature &signature)
+{
+    ar(signature.R);
+    ar(signature.s);
+}
+
+template <typename Archive> void serialize(Archive &ar, AutoMarketOrder &order)
+{
+    ar(order.storageID);
+    ar(order.accountID);
+    ar(order.tokenS);
+    ar(order.tokenB);
+    ar(order.amountS);
+    ar(order.amountB);
+    ar(order.validUntil);
+    ar(order.fillAmountBorS);
+    ar(order.taker);
+    ar(order.feeBips);
+    ar(order.tradingFee);
+    ar(order.feeTokenID);
+    ar(order.maxFee);
+    ar(order.type);
+    ar(order.gridOffset);
+    ar(order.orderOffset);
+    ar(order.maxLevel);
+    ar(order.useAppKey);
+}
+
+template <typename Archive> void serialize(Archive &ar, Order &order)
+{
+    ar(order.storageID);
+    ar(order.accountID);
+    ar(order.tokenS);
+    ar(order.tokenB);
+    ar(order.amountS);
+    ar(order.amountB);
+    ar(order.deltaFilledS);
+    ar(order.deltaFilledB);
+    ar(order.validUntil);
+    ar(order.fillAmountBorS);
+    ar(order.taker);
+    ar(order.feeBips);
+    ar(order.tradingFee);
+    ar(order.feeTokenID);
+    ar(order.fee);
+    ar(order.maxFee);
+    ar(order.type);
+    ar(order.level);
+    ar(order.startOrder);
+    ar(order.gridOffset);
+    ar(order.orderOffset);
+    ar(order.maxLevel);
+    ar(order.useAppKey);
+    ar(order.isNoop);
+}
+
+template <typename Archive> void serialize(Archive &ar, SpotTrade &spotTrade)
+{
+    ar(spotTrade.orderA);
+    ar(spotTrade.orderB);
+    ar(spotTrade.fillS_A);
+    ar(spotTrade.fillS_B);
+}
+
+template <typename Archive> void serialize(Archive &ar, BatchSpotTradeUser &user)
+{
+    ar(user.accountID);
+    ar(user.isNoop);
+    ar(user.orders);
+}
+
+template <typename Archive> void serialize(Archive &ar, BatchSpotTrade &batchSpotTrade)
+{
+    ar(batchSpotTrade.users);
+    ar(batchSpotTrade.tokens);
+    ar(batchSpotTrade.bindTokenID);
+}
+
+template <typename Archive> void serialize(Archive &ar, Deposit &deposit)
+{
+    ar(deposit.owner);
+    ar(deposit.accountID);
+    ar(deposit.tokenID);
+    ar(deposit.amount);
+    ar(deposit.type);
+}
+
+template <typename Archive> void serialize(Archive &ar, Withdrawal &withdrawal)
+{
+    ar(withdrawal.accountID);
+    ar(withdrawal.tokenID);
+    ar(withdrawal.amount);
+    ar(withdrawal.feeTokenID);
+    ar(withdrawal.fee);
+    ar(withdrawal.onchainDataHash);
+    ar(withdrawal.storageID);
+    ar(withdrawal.validUntil);
+    ar(withdrawal.maxFee);
+    ar(withdrawal.type);
+    ar(withdrawal.useAppKey);
+    ar(withdrawal.minGas);
+    ar(withdrawal.to);
+}
+
+template <typename Archive> void serialize(Archive &ar, AccountUpdateTx &update)
+{
+    ar(update.owner);
+    ar(update.accountID);
+    ar(update.publicKeyX);
+    ar(update.publicKeyY);
+    ar(update.feeTokenID);
+    ar(update.fee);
+    ar(update.maxFee);
+    ar(update.validUntil);
+    ar(update.type);
+}
+
+template <typename Archive> void serialize(Archive &ar, AppKeyUpdate &update)
+{
+    ar(update.accountID);
+    ar(update.appKeyPublicKeyX);
+    ar(update.appKeyPublicKeyY);
+    ar(update.feeTokenID);
+    ar(update.fee);
+    ar(update.maxFee);
+    ar(update.validUntil);
+    ar(update.disableAppKeySpotTrade);
+    ar(update.disableAppKeyWithdraw);
+    ar(update.disableAppKeyTransferToOther);
+}
+
+template <typename Archive> void serialize(Archive &ar, OrderCancel &update)
+{
+    ar(update.accountID);
+    ar(update.storageID);
+    ar(update.fee);
+    ar(update.maxFee);
+    ar(update.feeTokenID);
+    ar(update.useAppKey);
+}
+
+template <typename Archive> void serialize(Archive &ar, Transfer &transfer)
+{
+    ar(transfer.fromAccountID);
+    ar(transfer.toAccountID);
+    ar(transfer.tokenID);
+    ar(transfer.amount);
+    ar(transfer.feeTokenID);
+    ar(transfer.fee);
+    ar(transfer.validUntil);
+    ar(transfer.to);
+    ar(transfer.dualAuthorX);
+    ar(transfer.dualAuthorY);
+    ar(transfer.storageID);
+    ar(transfer.payerToAccountID);
+    ar(transfer.payerTo);
+    ar(transfer.payeeToAccountID);
+    ar(transfer.maxFee);
+    ar(transfer.putAddressesInDA);
+    ar(transfer.type);
+    ar(transfer.useAppKey);
+}
+
+template <typename Archive> void serialize(Archive &ar, Witness &state)
+{
+    ar(state.storageUpdate_A);
+    ar(state.storageUpdate_A_array);
+    ar(state.storageUpdate_B);
+    ar(state.storageUpdate_B_array);
+
+    ar(state.balanceUpdateS_A);
+    ar(state.balanceUpdateB_A);
+    ar(state.balanceUpdateFee_A);
+    ar(state.accountUpdate_A);
+
+    ar(state.balanceUpdateS_B);
+    ar(state.balanceUpdateB_B);
+    ar(state.balanceUpdateFee_B);
+    ar(state.accountUpdate_B);
+
+    ar(state.storageUpdate_C_array);
+    ar(state.balanceUpdateS_C);
+    ar(state.balanceUpdateB_C);
+    ar(state.balanceUpdateFee_C);
+    ar(state.accountUpdate_C);
+
+    ar(state.storageUpdate_D_array);
+    ar(state.balanceUpdateS_D);
+    ar(state.balanceUpdateB_D);
+    ar(state.balanceUpdateFee_D);
+    ar(state.accountUpdate_D);
+
+    ar(state.storageUpdate_E_array);
+    ar(state.balanceUpdateS_E);
+    ar(state.balanceUpdateB_E);
+    ar(state.balanceUpdateFee_E);
+    ar(state.accountUpdate_E);
+
+    ar(state.storageUpdate_F_array);
+    ar(state.balanceUpdateS_F);
+    ar(state.balanceUpdateB_F);
+    ar(state.balanceUpdateFee_F);
+    ar(state.accountUpdate_F);
+
+    ar(state.balanceUpdateA_O);
+    ar(state.balanceUpdateB_O);
+    ar(state.balanceUpdateC_O);
+    ar(state.balanceUpdateD_O);
+    ar(state.accountUpdate_O);
+
+    ar(state.signatureA);
+    ar(state.signatureB);
+    ar(state.signatureArray);
+
+    ar(state.numConditionalTransactionsAfter);
+}
+
+template <typename Archive> void serialize(Archive &ar, UniversalTransaction &transaction)
+{
+    ar(transaction.witness);
+    ar(transaction.type);
+    ar(transaction.spotTrade);
+    ar(transaction.batchSpotTrade);
+    ar(transaction.transfer);
+    ar(transaction.withdraw);
+    ar(transaction.deposit);
+    ar(transaction.accountUpdate);
+    ar(transaction.appKeyUpdate);
+    ar(transaction.orderCancel);
+}
+
+template <typename Archive> void serialize(Archive &ar, Block &block)
+{
+    ar(block.exchange);
+    ar(block.merkleRootBefore);
+    ar(block.merkleRootAfter);
+    ar(block.merkleAssetRootBefore);
+    ar(block.merkleAssetRootAfter);
+    ar(block.timestamp);
+    ar(block.protocolFeeBips);
+    ar(block.signature);
+    ar(block.accountUpdate_P);
+    ar(block.operatorAccountID);
+    ar(block.accountUpdate_O);
+    ar(block.transactions);
+}
+
+static bool isBinaryBlock(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(BINARY_BLOCK_MAGIC)] = {0};
+    file.read(magic, sizeof(magic));
+    return file.good() && memcmp(magic, BINARY_BLOCK_MAGIC, sizeof(magic)) == 0;
+}
+
+static bool writeBinaryBlock(
+  const Block &block,
+  unsigned int blockType,
+  unsigned int blockSize,
+  const std::string &filename)
+{
+    BinaryBlockWriter writer;
+    BinaryBlockHeader header = getBinaryBlockHeader(blockType, blockSize);
+    writer.writeBytes(&header, sizeof(header));
+    writer(block);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Cannot create block file: " << filename << std::endl;
+        return false;
+    }
+    file.write((const char *)writer.data.data(), writer.data.size());
+    return file.good();
+}
+
+static bool readBinaryBlock(
+  const uint8_t *data,
+  size_t size,
+  Block &block,
+  unsigned int &blockType,
+  unsigned int &blockSize)
+{
+    BinaryBlockReader reader(data, size);
+    const uint8_t *src = reader.take(sizeof(BinaryBlockHeader));
+    if (src == nullptr)
+    {
+        return false;
+    }
+    BinaryBlockHeader header;
+    memcpy(&header, src, sizeof(header));
+    BinaryBlockHeader expected = getBinaryBlockHeader(header.blockType, header.blockSize);
+    if (memcmp(&header, &expected, sizeof(header)) != 0)
+    {
+        std::cerr << "Unsupported binary block version" << std::endl;
+        return false;
+    }
+    blockType = header.blockType;
+    blockSize = header.blockSize;
+    reader(block);
+    return reader.good();
+}
+
+static bool readBinaryBlock(
+  const std::string &filename,
+  Block &block,
+  unsigned int &blockType,
+  unsigned int &blockSize)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Cannot open block file: " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    bool success = false;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+            success = readBinaryBlock((const uint8_t *)mapped, st.st_size, block, blockType, blockSize);
+            munmap(mapped, st.st_size);
+        }
+    }
+    close(fd);
+    if (!success)
+    {
+        std::cerr << "Invalid block file: " << filename << std::endl;
+    }
+    return success;
+}
+
+} // namespace Loopring
+
+#endif
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _BLAKE2B_H_
+#define _BLAKE2B_H_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Loopring
+{
+
+// Unkeyed BLAKE2b (RFC 7693), only used to derive hash function constants
+class Blake2b
+{
+  public:
+    static std::vector<uint8_t> hash(const uint8_t *data, size_t size, size_t outSize = 32)
+    {
+        static const uint64_t iv[8] = {
+          0x6a09e667f3bcc908ULL,
+          0xbb67ae8584caa73bULL,
+          0x3c6ef372fe94f82bULL,
+          0xa54ff53a5f1d36f1ULL,
+          0x510e527fade682d1ULL,
+          0x9b05688c2b3e6c1fULL,
+          0x1f83d9abfb41bd6bULL,
+          0x5be0cd19137e2179ULL};
+
+        uint64_t h[8];
+        memcpy(h, iv, sizeof(h));
+        h[0] ^= 0x01010000ULL ^ outSize;
+
+        uint64_t counter = 0;
+        uint8_t block[128];
+        // The last block (which can be full) is compressed with the final flag
+        while (size > 128)
+        {
+            counter += 128;
+            compress(h, data, counter, false);
+            data += 128;
+            size -= 128;
+        }
+        memset(block, 0, sizeof(block));
+        memcpy(block, data, size);
+        counter += size;
+        compress(h, block, counter, true);
+
+        std::vector<uint8_t> out(outSize);
+        for (size_t i = 0; i < outSize; i++)
+        {
+            out[i] = uint8_t(h[i / 8] >> (8 * (i % 8)));
+        }
+        return out;
+    }
+
+    static std::vector<uint8_t> hash(const std::vector<uint8_t> &data, size_t outSize = 32)
+    {
+        return hash(data.data(), data.size(), outSize);
+    }
+
+  private:
+    static uint64_t rotr(uint64_t x, unsigned int n)
+    {
+        return (x >> n) | (x << (64 - n));
+    }
+
+    static void mix(uint64_t *v, int a, int b, int c, int d, uint64_t x, uint64_t y)
+    {
+        v[a] = v[a] + v[b] + x;
+        v[d] = rotr(v[d] ^ v[a], 32);
+        v[c] = v[c] + v[d];
+        v[b] = rotr(v[b] ^ v[c], 24);
+        v[a] = v[a] + v[b] + y;
+        v[d] = rotr(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = rotr(v[b] ^ v[c], 63);
+    }
+
+    static void compress(uint64_t *h, const uint8_t *block, uint64_t counter, bool last)
+    {
+        static const uint8_t sigma[12][16] = {
+          {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+          {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+          {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+          {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+          {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+          {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+          {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+          {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+          {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+          {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+          {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+          {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+        static const uint64_t iv[8] = {
+          0x6a09e667f3bcc908ULL,
+          0xbb67ae8584caa73bULL,
+          0x3c6ef372fe94f82bULL,
+          0xa54ff53a5f1d36f1ULL,
+          0x510e527fade682d1ULL,
+          0x9b05688c2b3e6c1fULL,
+          0x1f83d9abfb41bd6bULL,
+          0x5be0cd19137e2179ULL};
+
+        uint64_t m[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            m[i] = 0;
+            for (unsigned int j = 0; j < 8; j++)
+            {
+                m[i] |= uint64_t(block[i * 8 + j]) << (8 * j);
+            }
+        }
+
+        uint64_t v[16];
+        for (unsigned int i = 0; i < 8; i++)
+        {
+            v[i] = h[i];
+            v[i + 8] = iv[i];
+        }
+        v[12] ^= counter;
+        if (last)
+        {
+            v[14] = ~v[14];
+        }
+
+        for (unsigned int i = 0; i < 12; i++)
+        {
+            const uint8_t *s = sigma[i];
+            mix(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            mix(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            mix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            mix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            mix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            mix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            mix(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            mix(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (unsigned int i = 0; i < 8; i++)
+        {
+            h[i] ^= v[i] ^ v[i + 8];
+        }
+    }
+};
+
+} // namespace Loopring
+
+#endif
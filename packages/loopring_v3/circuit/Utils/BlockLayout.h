@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _BLOCKLAYOUT_H_
+#define _BLOCKLAYOUT_H_
+
+#include "Data.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace Loopring
+{
+
+// Every block type is a different circuit with its own keys
+enum class BlockType
+{
+    // All transaction slots are full. Block types 1-3 are the same circuit.
+    Universal = 0,
+    // All transaction slots are light
+    Light = 4,
+    // Light transaction slots with 1/8 full slots in the middle
+    Mixed,
+
+    COUNT
+};
+
+// Block types 0-3 predate the light and mixed layouts and all use the universal circuit
+static unsigned int getCircuitBlockType(unsigned int blockType)
+{
+    return (blockType < (unsigned int)BlockType::Light) ? (unsigned int)BlockType::Universal : blockType;
+}
+
+// A full slot can hold every transaction type. A light slot only holds the
+// transactions that don't need the spot trades, the batch signatures, the
+// storage arrays or the accounts C-F, which are most of the constraints of a slot.
+static const std::vector<unsigned int> &getSlotTransactionTypes(bool full)
+{
+    static const std::vector<unsigned int> fullTypes = []() {
+        std::vector<unsigned int> types;
+        for (unsigned int i = 0; i < (unsigned int)TransactionType::COUNT; i++)
+        {
+            types.push_back(i);
+        }
+        return types;
+    }();
+    static const std::vector<unsigned int> lightTypes = {
+      (unsigned int)TransactionType::Noop,
+      (unsigned int)TransactionType::Transfer,
+      (unsigned int)TransactionType::Deposit,
+      (unsigned int)TransactionType::AccountUpdate,
+      (unsigned int)TransactionType::Withdrawal};
+    return full ? fullTypes : lightTypes;
+}
+
+static bool isLightTransactionType(TransactionType type)
+{
+    const std::vector<unsigned int> &types = getSlotTransactionTypes(false);
+    return std::find(types.begin(), types.end(), (unsigned int)type) != types.end();
+}
+
+// The slots [firstFull, firstFull + numFull) of a block are full, the others light.
+// Deposits and account updates come first and withdrawals last in a block
+// (see UniversalCircuit), so the full slots of a mixed block are in the middle.
+struct BlockLayout
+{
+    unsigned int numFull;
+    unsigned int firstFull;
+
+    bool isFull(unsigned int slot) const
+    {
+        return slot >= firstFull && slot < firstFull + numFull;
+    }
+};
+
+static BlockLayout getBlockLayout(unsigned int blockType, unsigned int blockSize)
+{
+    BlockLayout layout;
+    switch (BlockType(blockType))
+    {
+        case BlockType::Light:
+            layout.numFull = 0;
+            break;
+        case BlockType::Mixed:
+            layout.numFull = std::min(blockSize, std::max(1u, blockSize / 8));
+            break;
+        default:
+            layout.numFull = blockSize;
+            break;
+    }
+    layout.firstFull = (blockSize - layout.numFull) / 2;
+    return layout;
+}
+
+// Used in the names of the keys
+static std::string getBlockTypeName(unsigned int blockType)
+{
+    switch (BlockType(blockType))
+    {
+        case BlockType::Light:
+            return "light";
+        case BlockType::Mixed:
+            return "mixed";
+        default:
+            return "all";
+    }
+}
+
+} // namespace Loopring
+
+#endif
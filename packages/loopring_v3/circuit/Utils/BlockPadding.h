@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _BLOCKPADDING_H_
+#define _BLOCKPADDING_H_
+
+#include "BlockLayout.h"
+#include "Data.h"
+#include "UInt256.h"
+
+#include <vector>
+
+// Proving a block with a circuit larger than the block, the remaining slots are
+// filled with Noop transactions.
+//
+// Noops are "other" transactions, which can't come after the withdrawals, so the
+// padding is inserted before the first withdrawal. The padding repeats the Noop
+// in front of it: a Noop doesn't change the state, so its witness is valid for
+// all copies. Blocks that need padding therefore have to end their other
+// transactions with a Noop.
+//
+// The public data, and so the operator signature of the block, contains the
+// padding, so the block has to be signed for the block size it is padded to.
+
+namespace Loopring
+{
+
+static TransactionType getTransactionType(const UniversalTransaction &transaction)
+{
+    return TransactionType(UInt256(transaction.type).toUint64());
+}
+
+// Where the Noops are inserted
+static unsigned int getPaddingPosition(const Block &block)
+{
+    unsigned int position = block.transactions.size();
+    while (position > 0 && getTransactionType(block.transactions[position - 1]) == TransactionType::Withdrawal)
+    {
+        position--;
+    }
+    return position;
+}
+
+static bool canPadBlock(const Block &block)
+{
+    const unsigned int position = getPaddingPosition(block);
+    return position > 0 && getTransactionType(block.transactions[position - 1]) == TransactionType::Noop;
+}
+
+// Whether the transactions fit the slots of a block of `blockSize` after padding
+static bool fitsBlockSize(const Block &block, unsigned int blockType, unsigned int blockSize)
+{
+    const unsigned int numTransactions = block.transactions.size();
+    if (numTransactions > blockSize || (numTransactions < blockSize && !canPadBlock(block)))
+    {
+        return false;
+    }
+    const unsigned int position = getPaddingPosition(block);
+    const unsigned int numPadding = blockSize - numTransactions;
+    const BlockLayout layout = getBlockLayout(blockType, blockSize);
+    for (unsigned int i = 0; i < numTransactions; i++)
+    {
+        const unsigned int slot = (i < position) ? i : i + numPadding;
+        if (!layout.isFull(slot) && !isLightTransactionType(getTransactionType(block.transactions[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The smallest of `blockSizes` the block fits in, 0 if there is none
+static unsigned int selectBlockSize(
+  const Block &block,
+  unsigned int blockType,
+  const std::vector<unsigned int> &blockSizes)
+{
+    unsigned int selected = 0;
+    for (unsigned int blockSize : blockSizes)
+    {
+        if ((selected == 0 || blockSize < selected) && fitsBlockSize(block, blockType, blockSize))
+        {
+            selected = blockSize;
+        }
+    }
+    return selected;
+}
+
+// Pads the block to `blockSize` transactions, the block needs to fit (see fitsBlockSize)
+static void padBlock(Block &block, unsigned int blockSize)
+{
+    const unsigned int numTransactions = block.transactions.size();
+    if (numTransactions >= blockSize)
+    {
+        return;
+    }
+    const unsigned int position = getPaddingPosition(block);
+    const UniversalTransaction noop = block.transactions[position - 1];
+    block.transactions.insert(block.transactions.begin() + position, blockSize - numTransactions, noop);
+}
+
+} // namespace Loopring
+
+#endif
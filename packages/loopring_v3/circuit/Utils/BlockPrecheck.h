@@ -0,0 +1,769 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _BLOCKPRECHECK_H_
+#define _BLOCKPRECHECK_H_
+
+#include "Constants.h"
+#include "Data.h"
+#include "Poseidon.h"
+#include "UInt256.h"
+#include "Utils.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Loopring
+{
+
+struct PrecheckResult
+{
+    bool valid = true;
+    // Index of the first invalid transaction, -1 for the block itself
+    int transaction = -1;
+    std::string error;
+};
+
+// Checks the state transitions of a block natively, in a fraction of the time
+// needed to generate the witness, so obviously invalid blocks can be rejected
+// before starting the prover:
+// - the Merkle proofs of all account, asset, balance and storage updates
+//   against their roots before and after the update
+// - the balance roots of every account update chain through its balance updates
+// - the account (asset) roots chain from update to update, from
+//   merkleRootBefore through all transactions to merkleRootAfter
+// - the operator nonce increases by one
+// - the rules of spot trades, transfers, withdrawals, order cancellations,
+//   account updates and app key updates: validUntil, fee <= maxFee, the float
+//   accuracy of fees and amounts, the storage ID (nonce) rules and, for spot
+//   trades, token matching, takers, fill rates, fill limits and trading fees
+// Signatures, batch spot trades, deposits and the auto market order rules
+// (grid levels, order flips) are only checked by the circuit, so passing this
+// check doesn't mean the block is valid.
+class BlockPrecheck
+{
+  public:
+    static PrecheckResult check(const Block &block)
+    {
+        PrecheckResult result;
+        const int numTransactions = block.transactions.size();
+
+        // The transactions are checked in parallel, only the first error is kept
+        std::vector<std::string> errors(numTransactions);
+        std::atomic<int> firstInvalid(numTransactions);
+#ifdef MULTICORE
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < numTransactions; i++)
+        {
+            if (i > firstInvalid)
+            {
+                continue;
+            }
+            errors[i] = checkRules(block.transactions[i], block.timestamp);
+            if (errors[i].empty())
+            {
+                errors[i] = checkTransaction(block.transactions[i].witness);
+            }
+            if (!errors[i].empty())
+            {
+                int current = firstInvalid;
+                while (i < current && !firstInvalid.compare_exchange_weak(current, i))
+                {
+                }
+            }
+        }
+
+        // The account roots of consecutive transactions
+        ethsnarks::FieldT root = block.merkleRootBefore;
+        ethsnarks::FieldT assetRoot = block.merkleAssetRootBefore;
+        for (int i = 0; i < firstInvalid; i++)
+        {
+            const Witness &witness = block.transactions[i].witness;
+            if (!chains(witness.accountUpdate_A, root, assetRoot))
+            {
+                errors[i] = "accountUpdate_A does not start from the state after the previous transaction";
+                firstInvalid = i;
+                break;
+            }
+            root = witness.accountUpdate_O.rootAfter;
+            assetRoot = witness.accountUpdate_O.assetRootAfter;
+        }
+        if (firstInvalid < numTransactions)
+        {
+            result.valid = false;
+            result.transaction = firstInvalid;
+            result.error = errors[firstInvalid];
+            return result;
+        }
+
+        std::string error;
+        if (!checkAccount(block.accountUpdate_P, error, "accountUpdate_P") ||
+            !checkAccount(block.accountUpdate_O, error, "accountUpdate_O"))
+        {
+        }
+        else if (!chains(block.accountUpdate_P, root, assetRoot))
+        {
+            error = "accountUpdate_P does not start from the state after the last transaction";
+        }
+        else if (!chains(block.accountUpdate_O, block.accountUpdate_P.rootAfter, block.accountUpdate_P.assetRootAfter))
+        {
+            error = "accountUpdate_O does not start from the state after accountUpdate_P";
+        }
+        else if (block.accountUpdate_O.rootAfter != block.merkleRootAfter)
+        {
+            error = "merkleRootAfter does not match the state after the block";
+        }
+        else if (block.accountUpdate_O.assetRootAfter != block.merkleAssetRootAfter)
+        {
+            error = "merkleAssetRootAfter does not match the state after the block";
+        }
+        else if (block.accountUpdate_O.after.nonce != block.accountUpdate_O.before.nonce + ethsnarks::FieldT::one())
+        {
+            error = "the operator nonce is not increased by one";
+        }
+        if (!error.empty())
+        {
+            result.valid = false;
+            result.error = error;
+        }
+        return result;
+    }
+
+    // Root of the Merkle tree (arity 4) given a leaf and its proof
+    static ethsnarks::FieldT getMerkleRoot(const ethsnarks::FieldT &leaf, uint64_t address, const Proof &proof, unsigned int depth)
+    {
+        ethsnarks::FieldT node = leaf;
+        for (unsigned int i = 0; i < depth; i++)
+        {
+            // The node is the child at `position`, the siblings fill in the other children in order
+            const unsigned int position = (address >> (2 * i)) & 3;
+            ethsnarks::FieldT children[4];
+            unsigned int sibling = 0;
+            for (unsigned int c = 0; c < 4; c++)
+            {
+                children[c] = (c == position) ? node : proof.data[i * 3 + sibling++];
+            }
+            NativePoseidon_4::hash(children, 4, &node, 1);
+        }
+        return node;
+    }
+
+    static ethsnarks::FieldT hashAccount(const AccountLeaf &account)
+    {
+        return NativePoseidon_11::hash(
+          {account.owner,
+           account.publicKey.x,
+           account.publicKey.y,
+           account.appKeyPublicKey.x,
+           account.appKeyPublicKey.y,
+           account.nonce,
+           account.disableAppKeySpotTrade,
+           account.disableAppKeyWithdraw,
+           account.disableAppKeyTransferToOther,
+           account.balancesRoot,
+           account.storageRoot});
+    }
+
+    static ethsnarks::FieldT hashAssetAccount(const AccountLeaf &account)
+    {
+        return NativePoseidon_5::hash(
+          {account.owner, account.publicKey.x, account.publicKey.y, account.nonce, account.balancesRoot});
+    }
+
+    static ethsnarks::FieldT hashBalance(const BalanceLeaf &balance)
+    {
+        return NativePoseidon_4::hash({balance.balance});
+    }
+
+    static ethsnarks::FieldT hashStorage(const StorageLeaf &storage)
+    {
+        return NativePoseidon_7::hash(
+          {storage.tokenSID,
+           storage.tokenBID,
+           storage.data,
+           storage.storageID,
+           storage.gasFee,
+           storage.cancelled,
+           storage.forward});
+    }
+
+  private:
+    static uint64_t toAddress(const ethsnarks::FieldT &value, unsigned int depth)
+    {
+        return UInt256(value).toUint64() & ((uint64_t(1) << (2 * depth)) - 1);
+    }
+
+    static bool chains(const AccountUpdate &update, const ethsnarks::FieldT &root, const ethsnarks::FieldT &assetRoot)
+    {
+        return update.rootBefore == root && update.assetRootBefore == assetRoot;
+    }
+
+    // Sets `error` when a proof doesn't match the roots
+    template <typename Leaf>
+    static bool checkProof(
+      const char *name,
+      const Leaf &before,
+      const Leaf &after,
+      ethsnarks::FieldT (*hash)(const Leaf &),
+      uint64_t address,
+      const Proof &proof,
+      unsigned int depth,
+      const ethsnarks::FieldT &rootBefore,
+      const ethsnarks::FieldT &rootAfter,
+      std::string &error)
+    {
+        if (proof.data.size() != depth * 3)
+        {
+            error = std::string(name) + ": invalid proof size";
+        }
+        else if (getMerkleRoot(hash(before), address, proof, depth) != rootBefore)
+        {
+            error = std::string(name) + ": proof does not match rootBefore";
+        }
+        else if (getMerkleRoot(hash(after), address, proof, depth) != rootAfter)
+        {
+            error = std::string(name) + ": proof does not match rootAfter";
+        }
+        return error.empty();
+    }
+
+    static bool checkAccount(const AccountUpdate &update, std::string &error, const char *name)
+    {
+        const uint64_t address = toAddress(update.accountID, TREE_DEPTH_ACCOUNTS);
+        return checkProof(
+                 name,
+                 update.before,
+                 update.after,
+                 hashAccount,
+                 address,
+                 update.proof,
+                 TREE_DEPTH_ACCOUNTS,
+                 update.rootBefore,
+                 update.rootAfter,
+                 error) &&
+               checkProof(
+                 name,
+                 update.before,
+                 update.after,
+                 hashAssetAccount,
+                 address,
+                 update.assetProof,
+                 TREE_DEPTH_ACCOUNTS,
+                 update.assetRootBefore,
+                 update.assetRootAfter,
+                 error);
+    }
+
+    static bool checkBalance(const BalanceUpdate &update, std::string &error, const char *name)
+    {
+        return checkProof(
+          name,
+          update.before,
+          update.after,
+          hashBalance,
+          toAddress(update.tokenID, TREE_DEPTH_TOKENS),
+          update.proof,
+          TREE_DEPTH_TOKENS,
+          update.rootBefore,
+          update.rootAfter,
+          error);
+    }
+
+    static bool checkStorage(const StorageUpdate &update, std::string &error, const char *name)
+    {
+        return checkProof(
+          name,
+          update.before,
+          update.after,
+          hashStorage,
+          toAddress(update.storageID, TREE_DEPTH_STORAGE),
+          update.proof,
+          TREE_DEPTH_STORAGE,
+          update.rootBefore,
+          update.rootAfter,
+          error);
+    }
+
+    // The balance updates of an account, applied in order, go from the balances
+    // root before to the balances root after the account update
+    static bool checkBalances(
+      const AccountUpdate &account,
+      std::initializer_list<const BalanceUpdate *> balances,
+      std::string &error,
+      const char *name)
+    {
+        ethsnarks::FieldT root = account.before.balancesRoot;
+        for (const BalanceUpdate *balance : balances)
+        {
+            if (balance->rootBefore != root)
+            {
+                error = std::string(name) + ": balance updates are not chained";
+                return false;
+            }
+            root = balance->rootAfter;
+        }
+        if (root != account.after.balancesRoot)
+        {
+            error = std::string(name) + ": balancesRoot does not match the balance updates";
+            return false;
+        }
+        return true;
+    }
+
+    static bool fits(const ethsnarks::FieldT &value, unsigned int numBits)
+    {
+        return (UInt256(value) >> numBits).isZero();
+    }
+
+    // RequireAccuracyGadget on the float representation of `value`
+    static bool isAccurate(const UInt256 &value, const FloatEncoding &encoding, const Accuracy &accuracy)
+    {
+        const UInt256 floatValue = fromFloat(toFloat(value, encoding), encoding);
+        return floatValue <= value && value * accuracy.numerator <= floatValue * accuracy.denominator;
+    }
+
+    // FloatGadget and the range check of the decoded amount
+    static bool decodeFloat(const ethsnarks::FieldT &f, const FloatEncoding &encoding, UInt256 &value)
+    {
+        if (!fits(f, encoding.numBitsExponent + encoding.numBitsMantissa))
+        {
+            return false;
+        }
+        const uint64_t bits = UInt256(f).toUint64();
+        value = bits & ((uint64_t(1) << encoding.numBitsMantissa) - 1);
+        for (uint64_t i = 0; i < (bits >> encoding.numBitsMantissa); i++)
+        {
+            if (UInt256::mulOverflow(value, encoding.exponentBase, value))
+            {
+                return false;
+            }
+        }
+        return (value >> NUM_BITS_AMOUNT).isZero();
+    }
+
+    // The transaction is still valid at the block timestamp
+    static std::string checkValidUntil(const ethsnarks::FieldT &validUntil, const ethsnarks::FieldT &timestamp)
+    {
+        if (!fits(validUntil, NUM_BITS_TIMESTAMP) || UInt256(timestamp) >= UInt256(validUntil))
+        {
+            return "expired (validUntil <= timestamp)";
+        }
+        return "";
+    }
+
+    // The fee paid by the transaction: fee <= maxFee and fee fits in a Float16
+    static std::string checkFee(const ethsnarks::FieldT &fee, const ethsnarks::FieldT &maxFee)
+    {
+        if (!fits(fee, NUM_BITS_AMOUNT) || !fits(maxFee, NUM_BITS_AMOUNT))
+        {
+            return "fee out of range";
+        }
+        if (UInt256(fee) > UInt256(maxFee))
+        {
+            return "fee > maxFee";
+        }
+        if (!isAccurate(UInt256(fee), Float16Encoding, Float16Accuracy))
+        {
+            return "fee cannot be represented as a float";
+        }
+        return "";
+    }
+
+    // StorageReaderGadget: the storage ID cannot be smaller than the one in the slot,
+    // the slot is read as empty (forward = 1) when the storage ID is larger.
+    static std::string checkStorageID(
+      const ethsnarks::FieldT &storageID,
+      const StorageUpdate &storage,
+      StorageLeaf &history)
+    {
+        if (!fits(storageID, NUM_BITS_STORAGEID))
+        {
+            return "storageID out of range";
+        }
+        if (toAddress(storageID, TREE_DEPTH_STORAGE) != toAddress(storage.storageID, TREE_DEPTH_STORAGE))
+        {
+            return "storageID does not match the storage slot";
+        }
+        if (UInt256(storageID) < UInt256(storage.before.storageID))
+        {
+            return "storageID < storage slot storageID";
+        }
+        history = storage.before;
+        if (storageID != storage.before.storageID)
+        {
+            history.tokenSID = ethsnarks::FieldT::zero();
+            history.tokenBID = ethsnarks::FieldT::zero();
+            history.data = ethsnarks::FieldT::zero();
+            history.gasFee = ethsnarks::FieldT::zero();
+            history.cancelled = ethsnarks::FieldT::zero();
+            history.forward = ethsnarks::FieldT::one();
+        }
+        return "";
+    }
+
+    // NonceGadget: the storage ID is used once
+    static std::string checkNonce(const ethsnarks::FieldT &storageID, const StorageUpdate &storage)
+    {
+        StorageLeaf history;
+        std::string error = checkStorageID(storageID, storage, history);
+        if (error.empty() &&
+            (!history.tokenSID.is_zero() || !history.tokenBID.is_zero() || !history.data.is_zero() ||
+             !history.gasFee.is_zero() || !history.cancelled.is_zero() || history.forward != ethsnarks::FieldT::one()))
+        {
+            error = "storageID already used";
+        }
+        return error;
+    }
+
+    // OrderGadget and the OrderMatchingGadget/GasFeeMatchingGadget rules of one side of a spot trade
+    static std::string checkOrder(
+      const Order &order,
+      const StorageUpdate &storage,
+      const ethsnarks::FieldT &otherOwner,
+      const UInt256 &fillS,
+      const UInt256 &fillB,
+      const ethsnarks::FieldT &timestamp)
+    {
+        std::string error = checkFee(order.fee, order.maxFee);
+        if (error.empty())
+        {
+            error = checkValidUntil(order.validUntil, timestamp);
+        }
+        StorageLeaf history;
+        if (error.empty())
+        {
+            error = checkStorageID(order.storageID, storage, history);
+        }
+        if (!error.empty())
+        {
+            return error;
+        }
+        if (!fits(order.amountS, NUM_BITS_AMOUNT) || !fits(order.amountB, NUM_BITS_AMOUNT) ||
+            !fits(order.tradingFee, NUM_BITS_AMOUNT) || !fits(order.feeBips, NUM_BITS_BIPS))
+        {
+            return "amount out of range";
+        }
+        const bool isNormalOrder = order.type.is_zero();
+        if (isNormalOrder &&
+            (order.tokenS == order.tokenB || order.amountS.is_zero() || order.amountB.is_zero()))
+        {
+            return "invalid order";
+        }
+        if (!history.cancelled.is_zero())
+        {
+            return "order cancelled";
+        }
+        if (!order.taker.is_zero() && order.taker != otherOwner)
+        {
+            return "invalid taker";
+        }
+
+        // Fill rate, at most 0.1% worse than the order
+        const UInt256 amountS(order.amountS);
+        const UInt256 amountB(order.amountB);
+        if (fillS * amountB * 1000 > fillB * amountS * 1001 || fillS.isZero() != fillB.isZero())
+        {
+            return "invalid fill rate";
+        }
+
+        // The history of a new auto market order is reset by the circuit, using an
+        // empty history here only makes the checks below less strict.
+        const UInt256 filled = isNormalOrder ? UInt256(history.data) : UInt256();
+        const UInt256 gasFee = isNormalOrder ? UInt256(history.gasFee) : UInt256();
+        const bool fillAmountB = !order.fillAmountBorS.is_zero();
+        if (filled + (fillAmountB ? fillB : fillS) > (fillAmountB ? amountB : amountS))
+        {
+            return "fill limit exceeded";
+        }
+        if (UInt256(order.fee) + gasFee > UInt256(order.maxFee))
+        {
+            return "fee + previous fees > maxFee";
+        }
+
+        // The trading fee is paid in tokenB
+        const UInt256 tradingFee(order.tradingFee);
+        if (tradingFee > fillB * UInt256(order.feeBips) / 10000)
+        {
+            return "tradingFee > fillB * feeBips";
+        }
+        if (!isAccurate(tradingFee, Float32Encoding, Float32Accuracy))
+        {
+            return "tradingFee cannot be represented as a float";
+        }
+        return "";
+    }
+
+    static std::string checkSpotTrade(const SpotTrade &trade, const Witness &w, const ethsnarks::FieldT &timestamp)
+    {
+        UInt256 fillS_A;
+        UInt256 fillS_B;
+        if (!decodeFloat(trade.fillS_A, Float32Encoding, fillS_A) ||
+            !decodeFloat(trade.fillS_B, Float32Encoding, fillS_B))
+        {
+            return "fill out of range";
+        }
+        if (trade.orderA.tokenS != trade.orderB.tokenB || trade.orderA.tokenB != trade.orderB.tokenS)
+        {
+            return "tokens do not match";
+        }
+
+        std::string error = checkOrder(
+          trade.orderA,
+          w.storageUpdate_A,
+          w.accountUpdate_B.before.owner,
+          fillS_A,
+          fillS_B,
+          timestamp);
+        if (!error.empty())
+        {
+            return "orderA: " + error;
+        }
+        error = checkOrder(
+          trade.orderB,
+          w.storageUpdate_B,
+          w.accountUpdate_A.before.owner,
+          fillS_B,
+          fillS_A,
+          timestamp);
+        if (!error.empty())
+        {
+            return "orderB: " + error;
+        }
+        return "";
+    }
+
+    // The transfer amount is also stored as a float
+    static std::string checkTransfer(const Transfer &transfer, const Witness &w, const ethsnarks::FieldT &timestamp)
+    {
+        std::string error = checkFee(transfer.fee, transfer.maxFee);
+        if (error.empty())
+        {
+            error = checkValidUntil(transfer.validUntil, timestamp);
+        }
+        if (error.empty() &&
+            (!fits(transfer.amount, NUM_BITS_AMOUNT) ||
+             !isAccurate(UInt256(transfer.amount), Float32Encoding, Float32Accuracy)))
+        {
+            error = "amount cannot be represented as a float";
+        }
+        if (error.empty())
+        {
+            error = checkNonce(transfer.storageID, w.storageUpdate_A);
+        }
+        return error.empty() ? error : "transfer: " + error;
+    }
+
+    static std::string checkWithdrawal(
+      const Withdrawal &withdrawal,
+      const Witness &w,
+      const ethsnarks::FieldT &timestamp)
+    {
+        std::string error = checkFee(withdrawal.fee, withdrawal.maxFee);
+        if (error.empty())
+        {
+            error = checkValidUntil(withdrawal.validUntil, timestamp);
+        }
+        if (error.empty())
+        {
+            error = checkNonce(withdrawal.storageID, w.storageUpdate_A);
+        }
+        return error.empty() ? error : "withdrawal: " + error;
+    }
+
+    // OrderCancelledNonceGadget: the order can be cancelled once
+    static std::string checkOrderCancel(const OrderCancel &cancel, const Witness &w)
+    {
+        std::string error = checkFee(cancel.fee, cancel.maxFee);
+        StorageLeaf history;
+        if (error.empty())
+        {
+            error = checkStorageID(cancel.storageID, w.storageUpdate_A, history);
+        }
+        if (error.empty() && !history.cancelled.is_zero())
+        {
+            error = "order already cancelled";
+        }
+        return error.empty() ? error : "orderCancel: " + error;
+    }
+
+    // AccountUpdateTx and AppKeyUpdate only have a fee and validUntil to check
+    static std::string checkFeeAndValidUntil(
+      const char *name,
+      const ethsnarks::FieldT &fee,
+      const ethsnarks::FieldT &maxFee,
+      const ethsnarks::FieldT &validUntil,
+      const ethsnarks::FieldT &timestamp)
+    {
+        std::string error = checkFee(fee, maxFee);
+        if (error.empty())
+        {
+            error = checkValidUntil(validUntil, timestamp);
+        }
+        return error.empty() ? error : std::string(name) + ": " + error;
+    }
+
+    // The rules of the transaction itself, see the class comment for what is not checked
+    static std::string checkRules(const UniversalTransaction &tx, const ethsnarks::FieldT &timestamp)
+    {
+        switch (TransactionType(UInt256(tx.type).toUint64()))
+        {
+            case TransactionType::SpotTrade:
+                return checkSpotTrade(tx.spotTrade, tx.witness, timestamp);
+            case TransactionType::Transfer:
+                return checkTransfer(tx.transfer, tx.witness, timestamp);
+            case TransactionType::Withdrawal:
+                return checkWithdrawal(tx.withdraw, tx.witness, timestamp);
+            case TransactionType::OrderCancel:
+                return checkOrderCancel(tx.orderCancel, tx.witness);
+            case TransactionType::AccountUpdate:
+                return checkFeeAndValidUntil(
+                  "accountUpdate",
+                  tx.accountUpdate.fee,
+                  tx.accountUpdate.maxFee,
+                  tx.accountUpdate.validUntil,
+                  timestamp);
+            case TransactionType::AppKeyUpdate:
+                return checkFeeAndValidUntil(
+                  "appKeyUpdate",
+                  tx.appKeyUpdate.fee,
+                  tx.appKeyUpdate.maxFee,
+                  tx.appKeyUpdate.validUntil,
+                  timestamp);
+            default:
+                return "";
+        }
+    }
+
+    static std::string checkTransaction(const Witness &w)
+    {
+        std::string error;
+
+        // Storage
+        checkStorage(w.storageUpdate_A, error, "storageUpdate_A") &&
+          checkStorage(w.storageUpdate_B, error, "storageUpdate_B");
+        for (const std::vector<StorageUpdate> *updates :
+             {&w.storageUpdate_A_array,
+              &w.storageUpdate_B_array,
+              &w.storageUpdate_C_array,
+              &w.storageUpdate_D_array,
+              &w.storageUpdate_E_array,
+              &w.storageUpdate_F_array})
+        {
+            for (unsigned int i = 0; i < updates->size() && error.empty(); i++)
+            {
+                checkStorage((*updates)[i], error, "storageUpdate");
+            }
+        }
+        if (!error.empty())
+        {
+            return error;
+        }
+
+        // Balances
+        checkBalance(w.balanceUpdateS_A, error, "balanceUpdateS_A") &&
+          checkBalance(w.balanceUpdateB_A, error, "balanceUpdateB_A") &&
+          checkBalance(w.balanceUpdateFee_A, error, "balanceUpdateFee_A") &&
+          checkBalance(w.balanceUpdateS_B, error, "balanceUpdateS_B") &&
+          checkBalance(w.balanceUpdateB_B, error, "balanceUpdateB_B") &&
+          checkBalance(w.balanceUpdateFee_B, error, "balanceUpdateFee_B") &&
+          checkBalance(w.balanceUpdateS_C, error, "balanceUpdateS_C") &&
+          checkBalance(w.balanceUpdateB_C, error, "balanceUpdateB_C") &&
+          checkBalance(w.balanceUpdateFee_C, error, "balanceUpdateFee_C") &&
+          checkBalance(w.balanceUpdateS_D, error, "balanceUpdateS_D") &&
+          checkBalance(w.balanceUpdateB_D, error, "balanceUpdateB_D") &&
+          checkBalance(w.balanceUpdateFee_D, error, "balanceUpdateFee_D") &&
+          checkBalance(w.balanceUpdateS_E, error, "balanceUpdateS_E") &&
+          checkBalance(w.balanceUpdateB_E, error, "balanceUpdateB_E") &&
+          checkBalance(w.balanceUpdateFee_E, error, "balanceUpdateFee_E") &&
+          checkBalance(w.balanceUpdateS_F, error, "balanceUpdateS_F") &&
+          checkBalance(w.balanceUpdateB_F, error, "balanceUpdateB_F") &&
+          checkBalance(w.balanceUpdateFee_F, error, "balanceUpdateFee_F") &&
+          checkBalance(w.balanceUpdateD_O, error, "balanceUpdateD_O") &&
+          checkBalance(w.balanceUpdateC_O, error, "balanceUpdateC_O") &&
+          checkBalance(w.balanceUpdateB_O, error, "balanceUpdateB_O") &&
+          checkBalance(w.balanceUpdateA_O, error, "balanceUpdateA_O");
+        if (!error.empty())
+        {
+            return error;
+        }
+
+        // Accounts
+        checkAccount(w.accountUpdate_A, error, "accountUpdate_A") &&
+          checkAccount(w.accountUpdate_B, error, "accountUpdate_B") &&
+          checkAccount(w.accountUpdate_C, error, "accountUpdate_C") &&
+          checkAccount(w.accountUpdate_D, error, "accountUpdate_D") &&
+          checkAccount(w.accountUpdate_E, error, "accountUpdate_E") &&
+          checkAccount(w.accountUpdate_F, error, "accountUpdate_F") &&
+          checkAccount(w.accountUpdate_O, error, "accountUpdate_O");
+        if (!error.empty())
+        {
+            return error;
+        }
+
+        // Balance roots of the accounts
+        checkBalances(
+          w.accountUpdate_A,
+          {&w.balanceUpdateS_A, &w.balanceUpdateB_A, &w.balanceUpdateFee_A},
+          error,
+          "accountUpdate_A") &&
+          checkBalances(
+            w.accountUpdate_B,
+            {&w.balanceUpdateS_B, &w.balanceUpdateB_B, &w.balanceUpdateFee_B},
+            error,
+            "accountUpdate_B") &&
+          checkBalances(
+            w.accountUpdate_C,
+            {&w.balanceUpdateS_C, &w.balanceUpdateB_C, &w.balanceUpdateFee_C},
+            error,
+            "accountUpdate_C") &&
+          checkBalances(
+            w.accountUpdate_D,
+            {&w.balanceUpdateS_D, &w.balanceUpdateB_D, &w.balanceUpdateFee_D},
+            error,
+            "accountUpdate_D") &&
+          checkBalances(
+            w.accountUpdate_E,
+            {&w.balanceUpdateS_E, &w.balanceUpdateB_E, &w.balanceUpdateFee_E},
+            error,
+            "accountUpdate_E") &&
+          checkBalances(
+            w.accountUpdate_F,
+            {&w.balanceUpdateS_F, &w.balanceUpdateB_F, &w.balanceUpdateFee_F},
+            error,
+            "accountUpdate_F") &&
+          checkBalances(
+            w.accountUpdate_O,
+            {&w.balanceUpdateD_O, &w.balanceUpdateC_O, &w.balanceUpdateB_O, &w.balanceUpdateA_O},
+            error,
+            "accountUpdate_O");
+        if (!error.empty())
+        {
+            return error;
+        }
+
+        // Account roots within the transaction: A, B, C, D, E, F, O
+        const AccountUpdate *accounts[] = {
+          &w.accountUpdate_A,
+          &w.accountUpdate_B,
+          &w.accountUpdate_C,
+          &w.accountUpdate_D,
+          &w.accountUpdate_E,
+          &w.accountUpdate_F,
+          &w.accountUpdate_O};
+        for (unsigned int i = 1; i < 7; i++)
+        {
+            if (!chains(*accounts[i], accounts[i - 1]->rootAfter, accounts[i - 1]->assetRootAfter))
+            {
+                return "account updates are not chained";
+            }
+        }
+        return "";
+    }
+};
+
+} // namespace Loopring
+
+#endif
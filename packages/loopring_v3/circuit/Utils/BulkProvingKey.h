@@ -0,0 +1,279 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _BULKPROVINGKEY_H_
+#define _BULKPROVINGKEY_H_
+
+#include "ethsnarks.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Proving key stored in the in-memory representation of the points of this
+// build (curve, limb layout and Montgomery form). Every point array is read
+// with a single bulk read into the std::vectors of the proving key, which
+// skips the point decoding and validation of the raw format. The key is fully
+// resident in memory once loaded, like a key loaded from the raw format.
+// The file is only valid for builds using the same curve representation,
+// which is checked with the generators stored in the header.
+//
+// Layout (all sections 64-byte aligned):
+// - BulkProvingKeyHeader
+// - alpha_g1, beta_g1, beta_g2, delta_g1, delta_g2
+// - A_query, B_query, H_query, L_query
+//   (each: uint64 count [, uint64 domain size + count indices for sparse vectors], points)
+
+namespace Loopring
+{
+
+static const char BULK_PK_MAGIC[8] = {'D', 'G', 'P', 'K', 'B', 'L', 'K', '\0'};
+static const uint32_t BULK_PK_VERSION = 1;
+static const size_t BULK_PK_ALIGNMENT = 64;
+
+typedef libff::G1<ethsnarks::ppT> BulkG1T;
+typedef libff::G2<ethsnarks::ppT> BulkG2T;
+
+// The points are written and read as raw bytes
+static_assert(std::is_trivially_copyable<BulkG1T>::value, "G1 points must be trivially copyable");
+static_assert(std::is_trivially_copyable<BulkG2T>::value, "G2 points must be trivially copyable");
+
+struct BulkProvingKeyHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t sizeG1;
+    uint32_t sizeG2;
+    uint32_t reserved;
+    // Generators in the representation used to write the file
+    uint8_t g1[sizeof(BulkG1T)];
+    uint8_t g2[sizeof(BulkG2T)];
+};
+
+class BulkProvingKeyWriter
+{
+  public:
+    BulkProvingKeyWriter(const std::string &filename) : file(filename, std::ios::binary), offset(0)
+    {
+    }
+
+    bool good() const
+    {
+        return file.good();
+    }
+
+    template <typename T> void write(const T &value)
+    {
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <typename T> void write(const std::vector<T> &values)
+    {
+        align();
+        write(uint64_t(values.size()));
+        align();
+        writeBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    template <typename T> void write(const libsnark::sparse_vector<T> &values)
+    {
+        align();
+        write(uint64_t(values.values.size()));
+        write(uint64_t(values.domain_size_));
+        align();
+        std::vector<uint64_t> indices(values.indices.begin(), values.indices.end());
+        writeBytes(indices.data(), indices.size() * sizeof(uint64_t));
+        align();
+        writeBytes(values.values.data(), values.values.size() * sizeof(T));
+    }
+
+  private:
+    void writeBytes(const void *data, size_t size)
+    {
+        file.write((const char *)data, size);
+        offset += size;
+    }
+
+    void align()
+    {
+        static const char zeros[BULK_PK_ALIGNMENT] = {0};
+        size_t padding = (BULK_PK_ALIGNMENT - offset % BULK_PK_ALIGNMENT) % BULK_PK_ALIGNMENT;
+        writeBytes(zeros, padding);
+    }
+
+    std::ofstream file;
+    size_t offset;
+};
+
+class BulkProvingKeyReader
+{
+  public:
+    BulkProvingKeyReader(const std::string &filename) : file(filename, std::ios::binary), size(0), offset(0)
+    {
+        if (file.good())
+        {
+            file.seekg(0, std::ios::end);
+            size = file.tellg();
+            file.seekg(0, std::ios::beg);
+        }
+    }
+
+    bool good() const
+    {
+        return file.good();
+    }
+
+    template <typename T> void read(T &value)
+    {
+        readBytes(&value, sizeof(T));
+    }
+
+    template <typename T> void read(std::vector<T> &values)
+    {
+        align();
+        uint64_t count = 0;
+        read(count);
+        align();
+        if (fits(count, sizeof(T)))
+        {
+            values.resize(count);
+            readBytes(values.data(), count * sizeof(T));
+        }
+    }
+
+    template <typename T> void read(libsnark::sparse_vector<T> &values)
+    {
+        align();
+        uint64_t count = 0;
+        uint64_t domainSize = 0;
+        read(count);
+        read(domainSize);
+        align();
+        if (!fits(count, sizeof(uint64_t) + sizeof(T)))
+        {
+            return;
+        }
+        std::vector<uint64_t> indices(count);
+        readBytes(indices.data(), count * sizeof(uint64_t));
+        align();
+        values.domain_size_ = domainSize;
+        values.indices.assign(indices.begin(), indices.end());
+        values.values.resize(count);
+        readBytes(values.values.data(), count * sizeof(T));
+    }
+
+  private:
+    // Checks the count read from the file before allocating for it
+    bool fits(uint64_t count, size_t elementSize)
+    {
+        if (!file.good() || count > (size - offset) / elementSize)
+        {
+            file.setstate(std::ios::failbit);
+            return false;
+        }
+        return true;
+    }
+
+    void readBytes(void *dst, size_t length)
+    {
+        file.read((char *)dst, length);
+        offset += length;
+    }
+
+    void align()
+    {
+        size_t padding = (BULK_PK_ALIGNMENT - offset % BULK_PK_ALIGNMENT) % BULK_PK_ALIGNMENT;
+        file.seekg(padding, std::ios::cur);
+        offset += padding;
+    }
+
+    std::ifstream file;
+    uint64_t size;
+    uint64_t offset;
+};
+
+static BulkProvingKeyHeader getBulkProvingKeyHeader()
+{
+    BulkProvingKeyHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BULK_PK_MAGIC, sizeof(header.magic));
+    header.version = BULK_PK_VERSION;
+    header.sizeG1 = sizeof(BulkG1T);
+    header.sizeG2 = sizeof(BulkG2T);
+    BulkG1T g1 = BulkG1T::one();
+    BulkG2T g2 = BulkG2T::one();
+    memcpy(header.g1, &g1, sizeof(header.g1));
+    memcpy(header.g2, &g2, sizeof(header.g2));
+    return header;
+}
+
+static bool isBulkProvingKey(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(BULK_PK_MAGIC)] = {0};
+    file.read(magic, sizeof(magic));
+    return file.good() && memcmp(magic, BULK_PK_MAGIC, sizeof(magic)) == 0;
+}
+
+static bool writeBulkProvingKey(const ethsnarks::ProvingKeyT &pk, const std::string &filename)
+{
+    BulkProvingKeyWriter writer(filename);
+    if (!writer.good())
+    {
+        std::cerr << "Cannot create proving key file: " << filename << std::endl;
+        return false;
+    }
+    writer.write(getBulkProvingKeyHeader());
+    writer.write(pk.alpha_g1);
+    writer.write(pk.beta_g1);
+    writer.write(pk.beta_g2);
+    writer.write(pk.delta_g1);
+    writer.write(pk.delta_g2);
+    writer.write(pk.A_query);
+    writer.write(pk.B_query);
+    writer.write(pk.H_query);
+    writer.write(pk.L_query);
+    return writer.good();
+}
+
+static bool readBulkProvingKey(const std::string &filename, ethsnarks::ProvingKeyT &pk)
+{
+    BulkProvingKeyReader reader(filename);
+    if (!reader.good())
+    {
+        std::cerr << "Cannot open proving key file: " << filename << std::endl;
+        return false;
+    }
+    BulkProvingKeyHeader header;
+    reader.read(header);
+    BulkProvingKeyHeader expected = getBulkProvingKeyHeader();
+    if (!reader.good() || memcmp(&header, &expected, sizeof(header)) != 0)
+    {
+        std::cerr << "Proving key " << filename << " was written for a different curve representation "
+                  << "or version, regenerate it with -pk_raw2bulk" << std::endl;
+        return false;
+    }
+    reader.read(pk.alpha_g1);
+    reader.read(pk.beta_g1);
+    reader.read(pk.beta_g2);
+    reader.read(pk.delta_g1);
+    reader.read(pk.delta_g2);
+    reader.read(pk.A_query);
+    reader.read(pk.B_query);
+    reader.read(pk.H_query);
+    reader.read(pk.L_query);
+    if (!reader.good())
+    {
+        std::cerr << "Proving key file is truncated: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Loopring
+
+#endif
@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _CIRCUITSTATS_H_
+#define _CIRCUITSTATS_H_
+
+#include "Data.h"
+
+#include "ethsnarks.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// Generates the constraints of a gadget member, named after the member
+#define PROFILE_CONSTRAINTS(gadget) Loopring::ConstraintProfiler::generate(gadget, #gadget)
+
+namespace Loopring
+{
+
+struct GadgetStats
+{
+    unsigned int instances = 0;
+    size_t constraints = 0;
+    // Variables first used by the constraints of the gadget
+    size_t variables = 0;
+};
+
+// Constraints and variables of a circuit, by gadget class and by gadget path
+// (the member names from the circuit down to the gadget, e.g.
+// "transaction.updateAccount_A.pathUpdate"). Both include the
+// profiled gadgets nested inside, "(unprofiled)" is what's left.
+struct CircuitStats
+{
+    unsigned int blockType = 0;
+    unsigned int blockSize = 0;
+    size_t constraints = 0;
+    size_t variables = 0;
+    size_t inputs = 0;
+    std::map<std::string, GadgetStats> byClass;
+    std::map<std::string, GadgetStats> byPath;
+};
+
+static void to_json(json &j, const GadgetStats &stats)
+{
+    j = json{{"instances", stats.instances}, {"constraints", stats.constraints}, {"variables", stats.variables}};
+}
+
+static void from_json(const json &j, GadgetStats &stats)
+{
+    stats.instances = j.at("instances").get<unsigned int>();
+    stats.constraints = j.at("constraints").get<size_t>();
+    stats.variables = j.at("variables").get<size_t>();
+}
+
+static void to_json(json &j, const CircuitStats &stats)
+{
+    j = json{
+      {"blockType", stats.blockType},
+      {"blockSize", stats.blockSize},
+      {"constraints", stats.constraints},
+      {"variables", stats.variables},
+      {"inputs", stats.inputs},
+      {"byClass", stats.byClass},
+      {"byPath", stats.byPath}};
+}
+
+static void from_json(const json &j, CircuitStats &stats)
+{
+    stats.blockType = j.at("blockType").get<unsigned int>();
+    stats.blockSize = j.at("blockSize").get<unsigned int>();
+    stats.constraints = j.at("constraints").get<size_t>();
+    stats.variables = j.at("variables").get<size_t>();
+    stats.inputs = j.at("inputs").get<size_t>();
+    stats.byClass = j.at("byClass").get<std::map<std::string, GadgetStats>>();
+    stats.byPath = j.at("byPath").get<std::map<std::string, GadgetStats>>();
+}
+
+// Records which gadget generated which constraints while it is alive. Gadgets
+// generating their constraints with PROFILE_CONSTRAINTS (or generate) are
+// recorded, without an active profiler these just generate the constraints.
+// Constraint annotations are only kept in DEBUG builds, this works in all builds.
+class ConstraintProfiler
+{
+  public:
+    ConstraintProfiler(const ethsnarks::ProtoboardT &_pb) : pb(_pb), previous(active())
+    {
+        active() = this;
+    }
+
+    ~ConstraintProfiler()
+    {
+        active() = previous;
+    }
+
+    template <typename T> static void generate(T &gadget, const std::string &name)
+    {
+        ConstraintProfiler *profiler = active();
+        if (profiler == nullptr)
+        {
+            gadget.generate_r1cs_constraints();
+            return;
+        }
+        unsigned int range = profiler->open(name, getClassName(typeid(T)));
+        gadget.generate_r1cs_constraints();
+        profiler->close(range);
+    }
+
+    CircuitStats getStats() const
+    {
+        const size_t numConstraints = pb.num_constraints();
+
+        // Constraints and new variables of every range, excluding nested ranges
+        std::vector<size_t> selfConstraints(ranges.size() + 1, 0);
+        std::vector<size_t> selfVariables(ranges.size() + 1, 0);
+        std::vector<bool> used(pb.num_variables() + 1, false);
+        std::vector<unsigned int> openRanges;
+        unsigned int next = 0;
+        for (size_t i = 0; i < numConstraints; i++)
+        {
+            while (!openRanges.empty() && ranges[openRanges.back()].end <= i)
+            {
+                openRanges.pop_back();
+            }
+            while (next < ranges.size() && ranges[next].begin <= i)
+            {
+                if (ranges[next].end > i)
+                {
+                    openRanges.push_back(next);
+                }
+                next++;
+            }
+            // Constraints outside all ranges are stored last
+            const unsigned int range = openRanges.empty() ? ranges.size() : openRanges.back();
+            selfConstraints[range]++;
+            const auto &constraint = pb.constraint_system.constraints[i];
+            selfVariables[range] += countNewVariables(constraint->getA(), used) +
+                                    countNewVariables(constraint->getB(), used) +
+                                    countNewVariables(constraint->getC(), used);
+        }
+
+        // Nested ranges come after their parent
+        std::vector<size_t> constraints = selfConstraints;
+        std::vector<size_t> variables = selfVariables;
+        for (unsigned int r = ranges.size(); r-- > 0;)
+        {
+            if (ranges[r].parent >= 0)
+            {
+                constraints[ranges[r].parent] += constraints[r];
+                variables[ranges[r].parent] += variables[r];
+            }
+        }
+
+        CircuitStats stats;
+        stats.constraints = numConstraints;
+        stats.variables = pb.num_variables();
+        stats.inputs = pb.num_inputs();
+        for (unsigned int r = 0; r < ranges.size(); r++)
+        {
+            for (GadgetStats *gadgetStats : {&stats.byClass[ranges[r].className], &stats.byPath[ranges[r].path]})
+            {
+                gadgetStats->instances++;
+                gadgetStats->constraints += constraints[r];
+                gadgetStats->variables += variables[r];
+            }
+        }
+        GadgetStats &unprofiled = stats.byPath["(unprofiled)"];
+        unprofiled.instances = 1;
+        unprofiled.constraints = selfConstraints.back();
+        unprofiled.variables = selfVariables.back();
+        return stats;
+    }
+
+  private:
+    struct Range
+    {
+        std::string path;
+        std::string className;
+        size_t begin;
+        size_t end;
+        int parent;
+    };
+
+    const ethsnarks::ProtoboardT &pb;
+    ConstraintProfiler *previous;
+    std::vector<Range> ranges;
+    std::vector<unsigned int> stack;
+
+    static ConstraintProfiler *&active()
+    {
+        static ConstraintProfiler *profiler = nullptr;
+        return profiler;
+    }
+
+    static std::string getClassName(const std::type_info &type)
+    {
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        std::string name = (status == 0) ? demangled : type.name();
+        std::free(demangled);
+        return name;
+    }
+
+    static size_t countNewVariables(const libsnark::linear_combination<ethsnarks::FieldT> &lc, std::vector<bool> &used)
+    {
+        size_t count = 0;
+        for (const auto &term : lc.getTerms())
+        {
+            if (term.index != 0 && !used[term.index])
+            {
+                used[term.index] = true;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    unsigned int open(const std::string &name, const std::string &className)
+    {
+        const int parent = stack.empty() ? -1 : int(stack.back());
+        const std::string path = (parent < 0) ? name : ranges[parent].path + "." + name;
+        ranges.push_back({path, className, pb.num_constraints(), pb.num_constraints(), parent});
+        stack.push_back(ranges.size() - 1);
+        return ranges.size() - 1;
+    }
+
+    void close(unsigned int range)
+    {
+        ranges[range].end = pb.num_constraints();
+        stack.pop_back();
+    }
+};
+
+// Table of the differences between two builds of a circuit, largest changes first
+static std::string diffCircuitStats(const CircuitStats &before, const CircuitStats &after)
+{
+    struct Row
+    {
+        std::string name;
+        long long before;
+        long long after;
+    };
+    auto addRows = [](std::vector<Row> &rows,
+                      const std::string &prefix,
+                      const std::map<std::string, GadgetStats> &before,
+                      const std::map<std::string, GadgetStats> &after) {
+        std::map<std::string, Row> merged;
+        for (const auto &it : before)
+        {
+            merged[it.first] = {prefix + it.first, (long long)it.second.constraints, 0};
+        }
+        for (const auto &it : after)
+        {
+            Row &row = merged[it.first];
+            row.name = prefix + it.first;
+            row.after = it.second.constraints;
+        }
+        for (const auto &it : merged)
+        {
+            if (it.second.before != it.second.after)
+            {
+                rows.push_back(it.second);
+            }
+        }
+    };
+
+    std::vector<Row> rows;
+    addRows(rows, "class ", before.byClass, after.byClass);
+    addRows(rows, "path ", before.byPath, after.byPath);
+    std::stable_sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+        return std::abs(a.after - a.before) > std::abs(b.after - b.before);
+    });
+
+    std::stringstream ss;
+    auto printRow = [&ss](const std::string &name, long long before, long long after) {
+        ss << std::setw(12) << before << std::setw(12) << after << std::showpos << std::setw(12) << (after - before)
+           << std::noshowpos;
+        if (before != 0)
+        {
+            ss << std::setw(9) << std::fixed << std::setprecision(2) << (100.0 * (after - before) / before) << "%";
+        }
+        else
+        {
+            ss << std::setw(10) << "";
+        }
+        ss << "  " << name << std::endl;
+    };
+    ss << std::setw(12) << "before" << std::setw(12) << "after" << std::setw(12) << "delta" << std::setw(10) << ""
+       << "  constraints" << std::endl;
+    printRow("total", before.constraints, after.constraints);
+    printRow("variables", before.variables, after.variables);
+    for (const Row &row : rows)
+    {
+        printRow(row.name, row.before, row.after);
+    }
+    return ss.str();
+}
+
+} // namespace Loopring
+
+#endif
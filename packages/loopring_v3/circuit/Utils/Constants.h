@@ -70,10 +70,6 @@ namespace Loopring
     static const unsigned int ORDER_SIZE_USER_E = 1;
     static const unsigned int ORDER_SIZE_USER_F = 1;
 
-    static const char *LogDebug = "Debug";
-    static const char *LogInfo = "Info";
-    static const char *LogError = "Error";
-
     struct FloatEncoding
     {
         unsigned int numBitsExponent;
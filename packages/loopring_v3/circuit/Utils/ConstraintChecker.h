@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _CONSTRAINTCHECKER_H_
+#define _CONSTRAINTCHECKER_H_
+
+#include "ethsnarks.hpp"
+
+#include <atomic>
+#include <string>
+
+using namespace ethsnarks;
+
+namespace Loopring
+{
+
+// Checks the constraints of a protoboard on all threads and finds the first one
+// that isn't satisfied. The constraints are split in chunks that are checked in
+// order; chunks after an unsatisfied constraint that was already found are
+// skipped, so the check stops early and the result is the same as a serial check.
+class ConstraintChecker
+{
+  public:
+    static const size_t CHUNK_SIZE = 4096;
+
+    // Index of the first unsatisfied constraint, num_constraints() when all are satisfied
+    static size_t findFirstUnsatisfied(ProtoboardT &pb)
+    {
+        const size_t numConstraints = pb.num_constraints();
+        const long numChunks = (numConstraints + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        std::atomic<size_t> first(numConstraints);
+#ifdef MULTICORE
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (long chunk = 0; chunk < numChunks; chunk++)
+        {
+            const size_t begin = chunk * CHUNK_SIZE;
+            const size_t end = (begin + CHUNK_SIZE < numConstraints) ? begin + CHUNK_SIZE : numConstraints;
+            for (size_t i = begin; i < end && i < first; i++)
+            {
+                if (!isSatisfied(pb, i))
+                {
+                    size_t current = first;
+                    while (i < current && !first.compare_exchange_weak(current, i))
+                    {
+                    }
+                    break;
+                }
+            }
+        }
+        return first;
+    }
+
+    static bool isSatisfied(ProtoboardT &pb, size_t index)
+    {
+        const auto &constraint = pb.constraint_system.constraints[index];
+        return evaluate(pb, constraint->getA()) * evaluate(pb, constraint->getB()) ==
+               evaluate(pb, constraint->getC());
+    }
+
+    // Constraint annotations are only kept in DEBUG builds
+    static std::string getAnnotation(const ProtoboardT &pb, size_t index)
+    {
+#ifdef DEBUG
+        auto it = pb.constraint_system.constraint_annotations.find(index);
+        if (it != pb.constraint_system.constraint_annotations.end())
+        {
+            return it->second;
+        }
+#endif
+        return "(no annotation)";
+    }
+
+  private:
+    static FieldT evaluate(ProtoboardT &pb, const libsnark::linear_combination<FieldT> &lc)
+    {
+        FieldT result = FieldT::zero();
+        for (const auto &term : lc.getTerms())
+        {
+            const FieldT &coeff = term.coeff;
+            result += (term.index == 0) ? coeff : coeff * pb.val(VariableT(term.index));
+        }
+        return result;
+    }
+};
+
+} // namespace Loopring
+
+#endif
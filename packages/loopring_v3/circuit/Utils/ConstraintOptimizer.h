@@ -0,0 +1,575 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _CONSTRAINTOPTIMIZER_H_
+#define _CONSTRAINTOPTIMIZER_H_
+
+#include "Log.h"
+
+#include "ethsnarks.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Loopring
+{
+
+// Reduces a constraint system before generating the keys:
+// - linear constraints (A or B constant) are removed by substituting one of
+//   their variables in all other constraints
+// - identical constraints are only kept once
+// - variables not used by any constraint are dropped (primary inputs are kept)
+// - A and B are swapped in constraints where B has more terms than A, when that
+//   lowers the number of variables in B (the G2 multi-exponentiation)
+// The remaining variables keep their values, so the witness of the reduced
+// system is a selection of the witness of the original system (see
+// OptimizedConstraintSystem::assign).
+class ConstraintOptimizer
+{
+  public:
+    struct Options
+    {
+        bool eliminateLinear = true;
+        bool deduplicate = true;
+        bool removeUnused = true;
+        bool swapAB = true;
+        // Terms a substitution may add over all constraints using the variable
+        unsigned int maxFillIn = 64;
+    };
+
+    struct Stats
+    {
+        size_t constraintsBefore = 0;
+        size_t constraintsAfter = 0;
+        size_t variablesBefore = 0;
+        size_t variablesAfter = 0;
+        size_t eliminated = 0;
+        size_t duplicates = 0;
+        size_t swapped = 0;
+    };
+
+    ConstraintOptimizer(const ethsnarks::ProtoboardT &pb, const Options &_options = Options())
+        : options(_options), numInputs(pb.num_inputs()), numVariables(pb.num_variables())
+    {
+        const auto &constraints = pb.constraint_system.constraints;
+        system.resize(constraints.size());
+        for (size_t i = 0; i < constraints.size(); i++)
+        {
+            system[i].a = toLC(constraints[i]->getA());
+            system[i].b = toLC(constraints[i]->getB());
+            system[i].c = toLC(constraints[i]->getC());
+        }
+        stats.constraintsBefore = constraints.size();
+        stats.variablesBefore = numVariables;
+    }
+
+    // Runs the passes and writes the reduced system to the empty protoboard `out`.
+    // variables[i] is the variable in the original system of variable i in `out`.
+    void run(ethsnarks::ProtoboardT &out, std::vector<uint32_t> &variables)
+    {
+        if (options.eliminateLinear)
+        {
+            eliminateLinear();
+        }
+        if (options.deduplicate)
+        {
+            deduplicate();
+        }
+        if (options.swapAB)
+        {
+            swapAB();
+        }
+        build(out, variables);
+    }
+
+    const Stats &getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    struct Term
+    {
+        uint32_t index;
+        ethsnarks::FieldT coeff;
+    };
+    // Sorted on index, no zero coefficients
+    typedef std::vector<Term> LC;
+
+    struct Constraint
+    {
+        LC a;
+        LC b;
+        LC c;
+        bool removed = false;
+    };
+
+    Options options;
+    size_t numInputs;
+    size_t numVariables;
+    std::vector<Constraint> system;
+    Stats stats;
+
+    static LC toLC(const libsnark::linear_combination<ethsnarks::FieldT> &lc)
+    {
+        LC terms;
+        for (const auto &term : lc.getTerms())
+        {
+            const ethsnarks::FieldT &coeff = term.coeff;
+            terms.push_back({uint32_t(term.index), coeff});
+        }
+        std::sort(terms.begin(), terms.end(), [](const Term &x, const Term &y) { return x.index < y.index; });
+        LC result;
+        for (const Term &term : terms)
+        {
+            if (!result.empty() && result.back().index == term.index)
+            {
+                result.back().coeff += term.coeff;
+            }
+            else
+            {
+                result.push_back(term);
+            }
+        }
+        result.erase(
+          std::remove_if(result.begin(), result.end(), [](const Term &t) { return t.coeff.is_zero(); }), result.end());
+        return result;
+    }
+
+    static libsnark::linear_combination<ethsnarks::FieldT> toLibsnark(
+      const LC &lc,
+      const std::vector<uint32_t> &newIndices)
+    {
+        std::vector<libsnark::linear_term<ethsnarks::FieldT>> terms;
+        terms.reserve(lc.size());
+        for (const Term &term : lc)
+        {
+            terms.emplace_back(libsnark::variable<ethsnarks::FieldT>(newIndices[term.index]), term.coeff);
+        }
+        return libsnark::linear_combination<ethsnarks::FieldT>(terms);
+    }
+
+    // lc + scale * other
+    static LC addScaled(const LC &lc, const LC &other, const ethsnarks::FieldT &scale)
+    {
+        LC result;
+        result.reserve(lc.size() + other.size());
+        size_t i = 0, j = 0;
+        while (i < lc.size() || j < other.size())
+        {
+            if (j == other.size() || (i < lc.size() && lc[i].index < other[j].index))
+            {
+                result.push_back(lc[i++]);
+            }
+            else if (i == lc.size() || other[j].index < lc[i].index)
+            {
+                result.push_back({other[j].index, scale * other[j].coeff});
+                j++;
+            }
+            else
+            {
+                ethsnarks::FieldT coeff = lc[i].coeff + scale * other[j].coeff;
+                if (!coeff.is_zero())
+                {
+                    result.push_back({lc[i].index, coeff});
+                }
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    static bool isConstant(const LC &lc)
+    {
+        return lc.empty() || (lc.size() == 1 && lc[0].index == 0);
+    }
+
+    static ethsnarks::FieldT constantValue(const LC &lc)
+    {
+        return lc.empty() ? ethsnarks::FieldT::zero() : lc[0].coeff;
+    }
+
+    static const Term *find(const LC &lc, uint32_t index)
+    {
+        auto it = std::lower_bound(
+          lc.begin(), lc.end(), index, [](const Term &term, uint32_t value) { return term.index < value; });
+        return (it != lc.end() && it->index == index) ? &(*it) : nullptr;
+    }
+
+    // A constraint with A or B constant is the linear equation `result` = 0
+    static bool getLinear(const Constraint &constraint, LC &result)
+    {
+        if (isConstant(constraint.a))
+        {
+            result = addScaled(constraint.c, constraint.b, -constantValue(constraint.a));
+        }
+        else if (isConstant(constraint.b))
+        {
+            result = addScaled(constraint.c, constraint.a, -constantValue(constraint.b));
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    void eliminateLinear()
+    {
+        // Constraints using every variable, may contain constraints that no longer use it
+        std::vector<std::vector<uint32_t>> uses(numVariables + 1);
+        std::vector<uint32_t> worklist;
+        for (uint32_t k = 0; k < system.size(); k++)
+        {
+            for (const LC *lc : {&system[k].a, &system[k].b, &system[k].c})
+            {
+                for (const Term &term : *lc)
+                {
+                    if (term.index != 0 && (uses[term.index].empty() || uses[term.index].back() != k))
+                    {
+                        uses[term.index].push_back(k);
+                    }
+                }
+            }
+            LC linear;
+            if (getLinear(system[k], linear))
+            {
+                worklist.push_back(k);
+            }
+        }
+
+        std::reverse(worklist.begin(), worklist.end());
+        while (!worklist.empty())
+        {
+            const uint32_t k = worklist.back();
+            worklist.pop_back();
+            LC linear;
+            if (system[k].removed || !getLinear(system[k], linear))
+            {
+                continue;
+            }
+            if (linear.empty())
+            {
+                // 0 = 0
+                system[k].removed = true;
+                stats.eliminated++;
+                continue;
+            }
+
+            // The variable with the least fill-in, primary inputs can't be removed
+            const Term *pivot = nullptr;
+            size_t pivotCost = 0;
+            for (const Term &term : linear)
+            {
+                if (term.index <= numInputs)
+                {
+                    continue;
+                }
+                auto &termUses = uses[term.index];
+                std::sort(termUses.begin(), termUses.end());
+                termUses.erase(std::unique(termUses.begin(), termUses.end()), termUses.end());
+                // Every other constraint using the variable gets the other terms of the equation
+                const size_t cost = (linear.size() - 1) * (termUses.size() - 1);
+                if (pivot == nullptr || cost < pivotCost)
+                {
+                    pivot = &term;
+                    pivotCost = cost;
+                }
+            }
+            if (pivot == nullptr || pivotCost > options.maxFillIn)
+            {
+                continue;
+            }
+
+            // pivot = expression
+            const uint32_t variable = pivot->index;
+            LC expression;
+            const ethsnarks::FieldT scale = -pivot->coeff.inverse();
+            for (const Term &term : linear)
+            {
+                if (term.index != variable)
+                {
+                    expression.push_back({term.index, scale * term.coeff});
+                }
+            }
+            system[k].removed = true;
+            stats.eliminated++;
+
+            for (uint32_t j : uses[variable])
+            {
+                if (system[j].removed)
+                {
+                    continue;
+                }
+                bool substituted = false;
+                for (LC *lc : {&system[j].a, &system[j].b, &system[j].c})
+                {
+                    const Term *term = find(*lc, variable);
+                    if (term != nullptr)
+                    {
+                        const ethsnarks::FieldT coeff = term->coeff;
+                        LC withoutVariable;
+                        withoutVariable.reserve(lc->size());
+                        for (const Term &t : *lc)
+                        {
+                            if (t.index != variable)
+                            {
+                                withoutVariable.push_back(t);
+                            }
+                        }
+                        *lc = addScaled(withoutVariable, expression, coeff);
+                        substituted = true;
+                    }
+                }
+                if (substituted)
+                {
+                    for (const Term &term : expression)
+                    {
+                        if (term.index != 0)
+                        {
+                            uses[term.index].push_back(j);
+                        }
+                    }
+                    if (getLinear(system[j], linear))
+                    {
+                        worklist.push_back(j);
+                    }
+                }
+            }
+            uses[variable].clear();
+        }
+    }
+
+    static uint64_t hash(const LC &lc, uint64_t h)
+    {
+        for (const Term &term : lc)
+        {
+            const unsigned char *bytes = (const unsigned char *)&term.coeff;
+            h = (h ^ term.index) * 1099511628211ull;
+            for (size_t i = 0; i < sizeof(term.coeff); i++)
+            {
+                h = (h ^ bytes[i]) * 1099511628211ull;
+            }
+        }
+        return (h ^ 0xff) * 1099511628211ull;
+    }
+
+    static bool equal(const LC &x, const LC &y)
+    {
+        if (x.size() != y.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            if (x[i].index != y[i].index || x[i].coeff != y[i].coeff)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool lessThan(const LC &x, const LC &y)
+    {
+        if (x.size() != y.size())
+        {
+            return x.size() < y.size();
+        }
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            if (x[i].index != y[i].index)
+            {
+                return x[i].index < y[i].index;
+            }
+        }
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            const int order = memcmp(&x[i].coeff, &y[i].coeff, sizeof(x[i].coeff));
+            if (order != 0)
+            {
+                return order < 0;
+            }
+        }
+        return false;
+    }
+
+    void deduplicate()
+    {
+        // A * B = C and B * A = C are the same constraint
+        std::unordered_map<uint64_t, std::vector<uint32_t>> seen;
+        for (uint32_t k = 0; k < system.size(); k++)
+        {
+            Constraint &constraint = system[k];
+            if (constraint.removed)
+            {
+                continue;
+            }
+            const bool ordered = !lessThan(constraint.b, constraint.a);
+            const LC &first = ordered ? constraint.a : constraint.b;
+            const LC &second = ordered ? constraint.b : constraint.a;
+            const uint64_t h = hash(constraint.c, hash(second, hash(first, 14695981039346656037ull)));
+            bool duplicate = false;
+            for (uint32_t other : seen[h])
+            {
+                const Constraint &o = system[other];
+                const bool oOrdered = !lessThan(o.b, o.a);
+                if (equal(first, oOrdered ? o.a : o.b) && equal(second, oOrdered ? o.b : o.a) && equal(constraint.c, o.c))
+                {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (duplicate)
+            {
+                constraint.removed = true;
+                stats.duplicates++;
+            }
+            else
+            {
+                seen[h].push_back(k);
+            }
+        }
+    }
+
+    size_t countVariablesInB() const
+    {
+        std::vector<bool> used(numVariables + 1, false);
+        size_t count = 0;
+        for (const Constraint &constraint : system)
+        {
+            if (!constraint.removed)
+            {
+                for (const Term &term : constraint.b)
+                {
+                    if (!used[term.index])
+                    {
+                        used[term.index] = true;
+                        count++;
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    void swapAB()
+    {
+        const size_t before = countVariablesInB();
+        std::vector<uint32_t> swapped;
+        for (uint32_t k = 0; k < system.size(); k++)
+        {
+            if (!system[k].removed && system[k].b.size() > system[k].a.size())
+            {
+                std::swap(system[k].a, system[k].b);
+                swapped.push_back(k);
+            }
+        }
+        if (countVariablesInB() >= before)
+        {
+            for (uint32_t k : swapped)
+            {
+                std::swap(system[k].a, system[k].b);
+            }
+            swapped.clear();
+        }
+        stats.swapped = swapped.size();
+    }
+
+    void build(ethsnarks::ProtoboardT &out, std::vector<uint32_t> &variables)
+    {
+        // Primary inputs keep their index
+        std::vector<bool> used(numVariables + 1, !options.removeUnused);
+        for (size_t i = 0; i <= numInputs; i++)
+        {
+            used[i] = true;
+        }
+        for (const Constraint &constraint : system)
+        {
+            if (!constraint.removed)
+            {
+                for (const LC *lc : {&constraint.a, &constraint.b, &constraint.c})
+                {
+                    for (const Term &term : *lc)
+                    {
+                        used[term.index] = true;
+                    }
+                }
+            }
+        }
+
+        std::vector<uint32_t> newIndices(numVariables + 1, 0);
+        variables.clear();
+        for (uint32_t i = 0; i <= numVariables; i++)
+        {
+            if (used[i])
+            {
+                newIndices[i] = variables.size();
+                variables.push_back(i);
+            }
+        }
+
+        for (size_t i = 1; i < variables.size(); i++)
+        {
+            libsnark::pb_variable<ethsnarks::FieldT> var;
+            var.allocate(out);
+        }
+        out.set_input_sizes(numInputs);
+        for (const Constraint &constraint : system)
+        {
+            if (!constraint.removed)
+            {
+                out.add_r1cs_constraint(ethsnarks::ConstraintT(
+                  toLibsnark(constraint.a, newIndices),
+                  toLibsnark(constraint.b, newIndices),
+                  toLibsnark(constraint.c, newIndices)));
+            }
+        }
+        stats.constraintsAfter = out.num_constraints();
+        stats.variablesAfter = out.num_variables();
+    }
+};
+
+// A reduced constraint system with the mapping to fill in its witness from the
+// witness of the original system
+class OptimizedConstraintSystem
+{
+  public:
+    ethsnarks::ProtoboardT pb;
+    // variables[i] is the variable in the original system of variable i
+    std::vector<uint32_t> variables;
+    ConstraintOptimizer::Stats stats;
+
+    OptimizedConstraintSystem(
+      const ethsnarks::ProtoboardT &original,
+      const ConstraintOptimizer::Options &options = ConstraintOptimizer::Options())
+    {
+        ConstraintOptimizer optimizer(original, options);
+        optimizer.run(pb, variables);
+        stats = optimizer.getStats();
+        LOG(LogInfo,
+            "Optimized constraint system",
+            std::to_string(stats.constraintsBefore) + " -> " + std::to_string(stats.constraintsAfter) +
+              " constraints, " + std::to_string(stats.variablesBefore) + " -> " +
+              std::to_string(stats.variablesAfter) + " variables (" + std::to_string(stats.eliminated) +
+              " linear eliminated, " + std::to_string(stats.duplicates) + " duplicates, " +
+              std::to_string(stats.swapped) + " A/B swapped)");
+    }
+
+    void assign(const ethsnarks::ProtoboardT &original)
+    {
+        for (size_t i = 1; i < variables.size(); i++)
+        {
+            pb.val(ethsnarks::VariableT(i)) = original.val(ethsnarks::VariableT(variables[i]));
+        }
+    }
+};
+
+} // namespace Loopring
+
+#endif
@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _CONSTRAINTSYSTEMCACHE_H_
+#define _CONSTRAINTSYSTEMCACHE_H_
+
+#include "ethsnarks.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Hash of the circuit sources, generated by the build (see cmake/CircuitSourceHash.cmake).
+// Without it a cache can never be matched to the circuit it was created from.
+#if defined(__has_include)
+#if __has_include("CircuitSourceHash.h")
+#include "CircuitSourceHash.h"
+#endif
+#endif
+#ifndef CIRCUIT_SOURCE_HASH
+#define CIRCUIT_SOURCE_HASH ""
+#endif
+
+using namespace ethsnarks;
+
+namespace Loopring
+{
+
+static const char R1CS_CACHE_MAGIC[8] = {'D', 'G', 'R', '1', 'C', 'S', '\0', '\0'};
+static const uint32_t R1CS_CACHE_VERSION = 1;
+
+// Binary cache of the constraint system, used by the key generation modes only
+// (-createkeys, -exportcircuit). Proving needs the witness gadgets, which are
+// built together with the constraints, so it always builds the circuit.
+
+// Identifies the circuit a cached constraint system was generated for
+struct CircuitFingerprint
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t blockType;
+    uint32_t blockSize;
+    uint32_t sizeField;
+    char sourceHash[64];
+    // FieldT::one() in the representation used to write the file
+    uint8_t one[sizeof(FieldT)];
+};
+
+static CircuitFingerprint getCircuitFingerprint(unsigned int blockType, unsigned int blockSize)
+{
+    CircuitFingerprint fingerprint;
+    memset(&fingerprint, 0, sizeof(fingerprint));
+    memcpy(fingerprint.magic, R1CS_CACHE_MAGIC, sizeof(fingerprint.magic));
+    fingerprint.version = R1CS_CACHE_VERSION;
+    fingerprint.blockType = blockType;
+    fingerprint.blockSize = blockSize;
+    fingerprint.sizeField = sizeof(FieldT);
+    strncpy(fingerprint.sourceHash, CIRCUIT_SOURCE_HASH, sizeof(fingerprint.sourceHash));
+    FieldT one = FieldT::one();
+    memcpy(fingerprint.one, &one, sizeof(fingerprint.one));
+    return fingerprint;
+}
+
+// Binary R1CS layout:
+// - CircuitFingerprint
+// - uint64 primary input size, uint64 auxiliary input size, uint64 number of constraints
+// - for every constraint, for A, B and C: uint32 number of terms, (uint32 index, FieldT coeff) per term
+class ConstraintSystemWriter
+{
+  public:
+    ConstraintSystemWriter(const std::string &filename) : file(filename, std::ios::binary)
+    {
+    }
+
+    bool good() const
+    {
+        return file.good();
+    }
+
+    template <typename T> void write(const T &value)
+    {
+        file.write((const char *)&value, sizeof(T));
+    }
+
+    void write(const libsnark::linear_combination<FieldT> &lc)
+    {
+        const auto &terms = lc.getTerms();
+        write(uint32_t(terms.size()));
+        for (const auto &term : terms)
+        {
+            const FieldT &coeff = term.coeff;
+            write(uint32_t(term.index));
+            write(coeff);
+        }
+    }
+
+  private:
+    std::ofstream file;
+};
+
+class ConstraintSystemReader
+{
+  public:
+    ConstraintSystemReader(const std::string &filename) : file(filename, std::ios::binary)
+    {
+    }
+
+    bool good() const
+    {
+        return file.good();
+    }
+
+    template <typename T> void read(T &value)
+    {
+        file.read((char *)&value, sizeof(T));
+    }
+
+    void read(libsnark::linear_combination<FieldT> &lc)
+    {
+        uint32_t numTerms = 0;
+        read(numTerms);
+        if (!good())
+        {
+            return;
+        }
+        std::vector<libsnark::linear_term<FieldT>> terms;
+        terms.reserve(numTerms);
+        for (uint32_t i = 0; i < numTerms; i++)
+        {
+            uint32_t index = 0;
+            FieldT coeff;
+            read(index);
+            read(coeff);
+            terms.emplace_back(libsnark::variable<FieldT>(index), coeff);
+        }
+        lc = libsnark::linear_combination<FieldT>(terms);
+    }
+
+  private:
+    std::ifstream file;
+};
+
+static bool writeConstraintSystem(
+  const ProtoboardT &pb,
+  unsigned int blockType,
+  unsigned int blockSize,
+  const std::string &filename)
+{
+    if (strlen(CIRCUIT_SOURCE_HASH) == 0)
+    {
+        return false;
+    }
+    ConstraintSystemWriter writer(filename);
+    if (!writer.good())
+    {
+        std::cerr << "Cannot create constraint system cache: " << filename << std::endl;
+        return false;
+    }
+    const auto &cs = pb.constraint_system;
+    writer.write(getCircuitFingerprint(blockType, blockSize));
+    writer.write(uint64_t(cs.primary_input_size));
+    writer.write(uint64_t(cs.auxiliary_input_size));
+    writer.write(uint64_t(cs.constraints.size()));
+    for (const auto &constraint : cs.constraints)
+    {
+        writer.write(constraint->getA());
+        writer.write(constraint->getB());
+        writer.write(constraint->getC());
+    }
+    return writer.good();
+}
+
+// Loads a cached constraint system into an empty protoboard. Fails when the
+// cache was created for a different block, build or version of the circuit.
+static bool readConstraintSystem(
+  const std::string &filename,
+  unsigned int blockType,
+  unsigned int blockSize,
+  ProtoboardT &pb)
+{
+    if (strlen(CIRCUIT_SOURCE_HASH) == 0)
+    {
+        return false;
+    }
+    ConstraintSystemReader reader(filename);
+    if (!reader.good())
+    {
+        return false;
+    }
+    CircuitFingerprint fingerprint;
+    reader.read(fingerprint);
+    CircuitFingerprint expected = getCircuitFingerprint(blockType, blockSize);
+    if (!reader.good() || memcmp(&fingerprint, &expected, sizeof(fingerprint)) != 0)
+    {
+        std::cout << "Constraint system cache " << filename << " is outdated" << std::endl;
+        return false;
+    }
+
+    uint64_t primaryInputSize = 0;
+    uint64_t auxiliaryInputSize = 0;
+    uint64_t numConstraints = 0;
+    reader.read(primaryInputSize);
+    reader.read(auxiliaryInputSize);
+    reader.read(numConstraints);
+
+    // Allocate all variables so the protoboard can also be used to set values
+    for (uint64_t i = 0; i < primaryInputSize + auxiliaryInputSize && reader.good(); i++)
+    {
+        libsnark::pb_variable<FieldT> var;
+        var.allocate(pb);
+    }
+    pb.set_input_sizes(primaryInputSize);
+
+    pb.constraint_system.constraints.reserve(numConstraints);
+    for (uint64_t i = 0; i < numConstraints && reader.good(); i++)
+    {
+        libsnark::linear_combination<FieldT> A, B, C;
+        reader.read(A);
+        reader.read(B);
+        reader.read(C);
+        pb.add_r1cs_constraint(ConstraintT(A, B, C));
+    }
+    if (!reader.good())
+    {
+        std::cerr << "Constraint system cache is truncated: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Loopring
+
+#endif
@@ -799,6 +799,33 @@ enum class TransactionType
     COUNT
 };
 
+static const char *transactionTypeToString(TransactionType type)
+{
+    switch (type)
+    {
+        case TransactionType::Noop:
+            return "Noop";
+        case TransactionType::Transfer:
+            return "Transfer";
+        case TransactionType::SpotTrade:
+            return "SpotTrade";
+        case TransactionType::OrderCancel:
+            return "OrderCancel";
+        case TransactionType::AppKeyUpdate:
+            return "AppKeyUpdate";
+        case TransactionType::BatchSpotTrade:
+            return "BatchSpotTrade";
+        case TransactionType::Deposit:
+            return "Deposit";
+        case TransactionType::AccountUpdate:
+            return "AccountUpdate";
+        case TransactionType::Withdrawal:
+            return "Withdrawal";
+        default:
+            return "Unknown";
+    }
+}
+
 class Proof
 {
   public:
@@ -967,6 +994,13 @@ static void from_json(const json &j, Signature &signature)
     signature.s = ethsnarks::FieldT(j.at("s").get<std::string>().c_str());
 }
 
+// The dummy data is decoded only once, the templates are copied for every transaction
+static const Signature &getDummySignature()
+{
+    static const Signature dummy = dummySignature.get<Signature>();
+    return dummy;
+}
+
 class AutoMarketOrder
 {
   public:
@@ -1104,6 +1138,18 @@ static void from_json(const json &j, SpotTrade &spotTrade)
     spotTrade.fillS_B = ethsnarks::FieldT(j["fFillS_B"]);
 }
 
+static const SpotTrade &getDummySpotTrade()
+{
+    static const SpotTrade dummy = dummySpotTrade.get<SpotTrade>();
+    return dummy;
+}
+
+static const Order &getDummyBatchSpotTradeOrder()
+{
+    static const Order dummy = dummyBatchSpotTradeOrder.get<Order>();
+    return dummy;
+}
+
 class BatchSpotTradeUser
 {
   public:
@@ -1131,10 +1177,16 @@ static void from_json(const json &j, BatchSpotTradeUser &batchSpotTradeUser)
     }
     for (unsigned int i = 0; i < size - jOrders.size(); i++) 
     {
-        batchSpotTradeUser.orders.emplace_back(dummyBatchSpotTradeOrder.get<Loopring::Order>());
+        batchSpotTradeUser.orders.emplace_back(getDummyBatchSpotTradeOrder());
     }
 }
 
+static const BatchSpotTradeUser &getDummyBatchSpotTradeUser()
+{
+    static const BatchSpotTradeUser dummy = dummyBatchSpotTradeUser.get<BatchSpotTradeUser>();
+    return dummy;
+}
+
 class BatchSpotTrade
 {
   public:
@@ -1168,7 +1220,7 @@ static void from_json(const json &j, BatchSpotTrade &batchSpotTrade)
     }
     for (unsigned int i = jUsers.size(); i < BATCH_SPOT_TRADE_MAX_USER; i++) 
     {
-        batchSpotTrade.users.emplace_back(dummyBatchSpotTradeUser.get<Loopring::BatchSpotTradeUser>());
+        batchSpotTrade.users.emplace_back(getDummyBatchSpotTradeUser());
     }
     json jTokens = j["tokens"];
     for (unsigned int i = 0; i < BATCH_SPOT_TRADE_MAX_TOKENS; i++)
@@ -1177,6 +1229,12 @@ static void from_json(const json &j, BatchSpotTrade &batchSpotTrade)
     }
 }
 
+static const BatchSpotTrade &getDummyBatchSpotTrade()
+{
+    static const BatchSpotTrade dummy = dummyBatchSpotTrade.get<BatchSpotTrade>();
+    return dummy;
+}
+
 class Deposit
 {
   public:
@@ -1196,6 +1254,12 @@ static void from_json(const json &j, Deposit &deposit)
     deposit.type = ethsnarks::FieldT(j.at("type"));
 }
 
+static const Deposit &getDummyDeposit()
+{
+    static const Deposit dummy = dummyDeposit.get<Deposit>();
+    return dummy;
+}
+
 class Withdrawal
 {
   public:
@@ -1232,6 +1296,12 @@ static void from_json(const json &j, Withdrawal &withdrawal)
     withdrawal.to = ethsnarks::FieldT(j["to"].get<std::string>().c_str());
 }
 
+static const Withdrawal &getDummyWithdraw()
+{
+    static const Withdrawal dummy = dummyWithdraw.get<Withdrawal>();
+    return dummy;
+}
+
 class AccountUpdateTx
 {
   public:
@@ -1258,6 +1328,13 @@ static void from_json(const json &j, AccountUpdateTx &update)
     update.validUntil = ethsnarks::FieldT(j.at("validUntil"));
     update.type = ethsnarks::FieldT(j.at("type"));
 }
+
+static const AccountUpdateTx &getDummyAccountUpdate()
+{
+    static const AccountUpdateTx dummy = dummyAccountUpdate.get<AccountUpdateTx>();
+    return dummy;
+}
+
 class AppKeyUpdate
 {
   public:
@@ -1287,6 +1364,12 @@ static void from_json(const json &j, AppKeyUpdate &update)
     update.disableAppKeyTransferToOther = ethsnarks::FieldT(j.at("disableAppKeyTransferToOther"));
 }
 
+static const AppKeyUpdate &getDummyAppKeyUpdate()
+{
+    static const AppKeyUpdate dummy = dummyAppKeyUpdate.get<AppKeyUpdate>();
+    return dummy;
+}
+
 class OrderCancel
 {
   public:
@@ -1307,6 +1390,12 @@ static void from_json(const json &j, OrderCancel &update)
     update.useAppKey = ethsnarks::FieldT(j.at("useAppKey"));
 }
 
+static const OrderCancel &getDummyOrderCancel()
+{
+    static const OrderCancel dummy = dummyOrderCancel.get<OrderCancel>();
+    return dummy;
+}
+
 class Transfer
 {
   public:
@@ -1352,6 +1441,12 @@ static void from_json(const json &j, Transfer &transfer)
     transfer.useAppKey = ethsnarks::FieldT(j.at("useAppKey"));
 }
 
+static const Transfer &getDummyTransfer()
+{
+    static const Transfer dummy = dummyTransfer.get<Transfer>();
+    return dummy;
+}
+
 class Witness
 {
   public:
@@ -1515,19 +1610,11 @@ static void from_json(const json &j, Witness &state)
     state.balanceUpdateA_O = j.at("balanceUpdateA_O").get<BalanceUpdate>();
     state.accountUpdate_O = j.at("accountUpdate_O").get<AccountUpdate>();
 
-    state.signatureA = dummySignature.get<Signature>();
-    state.signatureB = dummySignature.get<Signature>();
+    state.signatureA = getDummySignature();
+    state.signatureB = getDummySignature();
 
-
-    for (unsigned int i = 0; i < BATCH_SPOT_TRADE_MAX_USER; i++)
-    {
-        std::vector<Signature> userSignatureArray;
-        state.signatureArray.emplace_back(userSignatureArray);
-        for (unsigned int j = 0; j < ORDER_SIZE_USER_MAX; j++) 
-        {
-            state.signatureArray[i].emplace_back(dummySignature.get<Signature>());
-        }
-    }
+    state.signatureArray.assign(
+      BATCH_SPOT_TRADE_MAX_USER, std::vector<Signature>(ORDER_SIZE_USER_MAX, getDummySignature()));
 
     state.numConditionalTransactionsAfter = ethsnarks::FieldT(j.at("numConditionalTransactionsAfter"));
 
@@ -1580,14 +1667,14 @@ static void from_json(const json &j, UniversalTransaction &transaction)
     transaction.witness = j.at("witness").get<Witness>();
 
     // Fill in dummy data for all tx types
-    transaction.spotTrade = dummySpotTrade.get<Loopring::SpotTrade>();
-    transaction.batchSpotTrade = dummyBatchSpotTrade.get<Loopring::BatchSpotTrade>();
-    transaction.transfer = dummyTransfer.get<Loopring::Transfer>();
-    transaction.withdraw = dummyWithdraw.get<Loopring::Withdrawal>();
-    transaction.deposit = dummyDeposit.get<Loopring::Deposit>();
-    transaction.accountUpdate = dummyAccountUpdate.get<Loopring::AccountUpdateTx>();
-    transaction.orderCancel = dummyOrderCancel.get<Loopring::OrderCancel>();
-    transaction.appKeyUpdate = dummyAppKeyUpdate.get<Loopring::AppKeyUpdate>();
+    transaction.spotTrade = getDummySpotTrade();
+    transaction.batchSpotTrade = getDummyBatchSpotTrade();
+    transaction.transfer = getDummyTransfer();
+    transaction.withdraw = getDummyWithdraw();
+    transaction.deposit = getDummyDeposit();
+    transaction.accountUpdate = getDummyAccountUpdate();
+    transaction.orderCancel = getDummyOrderCancel();
+    transaction.appKeyUpdate = getDummyAppKeyUpdate();
 
     // Patch some of the dummy tx's so they are valid against the current state
     // Deposit
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _FIELDBATCH_H_
+#define _FIELDBATCH_H_
+
+#include "ethsnarks.hpp"
+
+#include <vector>
+
+namespace Loopring
+{
+
+// Inverts all values using Montgomery's trick: a single field inversion and
+// 3(n - 1) multiplications instead of n inversions. Zeros are left as zero.
+static void batchInverse(std::vector<ethsnarks::FieldT> &values)
+{
+    // prefix[i] = product of the non-zero values before i
+    std::vector<ethsnarks::FieldT> prefix(values.size());
+    ethsnarks::FieldT product = ethsnarks::FieldT::one();
+    for (unsigned int i = 0; i < values.size(); i++)
+    {
+        prefix[i] = product;
+        if (!values[i].is_zero())
+        {
+            product *= values[i];
+        }
+    }
+
+    ethsnarks::FieldT inverse = product.inverse();
+    for (unsigned int i = values.size(); i-- > 0;)
+    {
+        if (!values[i].is_zero())
+        {
+            ethsnarks::FieldT value = values[i];
+            values[i] = inverse * prefix[i];
+            inverse *= value;
+        }
+    }
+}
+
+// Square roots can't be shared like inversions, but they are independent so
+// with MULTICORE they are split over the threads.
+static void batchSqrt(std::vector<ethsnarks::FieldT> &values)
+{
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (unsigned int i = 0; i < values.size(); i++)
+    {
+        values[i] = values[i].sqrt();
+    }
+}
+
+} // namespace Loopring
+
+#endif
@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _JOBQUEUE_H_
+#define _JOBQUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Loopring
+{
+
+enum class JobStatus
+{
+    Queued = 0,
+    Witness,
+    Proving,
+    Done,
+    Failed
+};
+
+static const char *jobStatusToString(JobStatus status)
+{
+    switch (status)
+    {
+        case JobStatus::Queued:
+            return "queued";
+        case JobStatus::Witness:
+            return "witness";
+        case JobStatus::Proving:
+            return "proving";
+        case JobStatus::Done:
+            return "done";
+        case JobStatus::Failed:
+            return "failed";
+        default:
+            return "unknown";
+    }
+}
+
+// Self-verification of the proof of a finished job. This is reported next to
+// the job status: a job whose proof fails the verification stays Done.
+enum class ProofCheck
+{
+    None = 0,
+    Pending,
+    Verified,
+    Invalid
+};
+
+static const char *proofCheckToString(ProofCheck check)
+{
+    switch (check)
+    {
+        case ProofCheck::None:
+            return "none";
+        case ProofCheck::Pending:
+            return "pending";
+        case ProofCheck::Verified:
+            return "verified";
+        case ProofCheck::Invalid:
+            return "verify_failed";
+        default:
+            return "unknown";
+    }
+}
+
+struct ProverJob
+{
+    unsigned int id = 0;
+    std::string blockFilename;
+    std::string proofFilename;
+    bool validate = false;
+    bool delFile = false;
+
+    JobStatus status = JobStatus::Queued;
+    // The proof (json) when done, the error message when failed
+    std::string result;
+    ProofCheck proofCheck = ProofCheck::None;
+    // The block size the block is proven with (0 until known)
+    unsigned int blockSize = 0;
+    // The block has no block size and is padded to `blockSize`
+    bool padded = false;
+
+    std::chrono::system_clock::time_point submitted;
+    std::chrono::system_clock::time_point started;
+    std::chrono::system_clock::time_point finished;
+
+    bool isActive() const
+    {
+        return status == JobStatus::Witness || status == JobStatus::Proving;
+    }
+
+    bool isFinished() const
+    {
+        return status == JobStatus::Done || status == JobStatus::Failed;
+    }
+};
+
+// Bounded FIFO of prover jobs shared between the HTTP threads (producers) and
+// the prover workers (consumers). All job state is owned by the queue and only
+// ever handed out as copies, so callers never race with the worker.
+class JobQueue
+{
+  public:
+    JobQueue(unsigned int _capacity, unsigned int _maxFinishedJobs = 256)
+        : capacity(_capacity), maxFinishedJobs(_maxFinishedJobs), nextID(1), stopped(false)
+    {
+    }
+
+    // Returns false if the queue is full or stopped.
+    bool submit(ProverJob &job)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (stopped || pending.size() >= capacity)
+        {
+            return false;
+        }
+        job.id = nextID++;
+        job.status = JobStatus::Queued;
+        job.result.clear();
+        job.submitted = std::chrono::system_clock::now();
+        jobs[job.id] = job;
+        pending.push_back(job.id);
+        cvPending.notify_one();
+        return true;
+    }
+
+    // Blocks until a job is available and marks it as started (witness generation).
+    // Returns false once the queue is stopped.
+    bool pop(ProverJob &job)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cvPending.wait(lock, [this] { return stopped || !pending.empty(); });
+        if (stopped)
+        {
+            return false;
+        }
+        ProverJob &stored = jobs[pending.front()];
+        pending.pop_front();
+        stored.status = JobStatus::Witness;
+        stored.started = std::chrono::system_clock::now();
+        job = stored;
+        return true;
+    }
+
+    void setStatus(unsigned int id, JobStatus status)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = jobs.find(id);
+        if (it != jobs.end() && !it->second.isFinished())
+        {
+            it->second.status = status;
+        }
+    }
+
+    void setBlockSize(unsigned int id, unsigned int blockSize)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = jobs.find(id);
+        if (it != jobs.end())
+        {
+            it->second.blockSize = blockSize;
+        }
+    }
+
+    void finish(unsigned int id, bool success, const std::string &result, ProofCheck proofCheck = ProofCheck::None)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = jobs.find(id);
+        if (it == jobs.end())
+        {
+            return;
+        }
+        it->second.proofCheck = proofCheck;
+        markFinished(it->second, success, result);
+        cvFinished.notify_all();
+    }
+
+    // Reports the result of a verification done after the job was finished.
+    // The status of the job is final and left as is.
+    void setProofCheck(unsigned int id, bool verified)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = jobs.find(id);
+        if (it == jobs.end() || it->second.proofCheck != ProofCheck::Pending)
+        {
+            return;
+        }
+        it->second.proofCheck = verified ? ProofCheck::Verified : ProofCheck::Invalid;
+    }
+
+    bool get(unsigned int id, ProverJob &job) const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = jobs.find(id);
+        if (it == jobs.end())
+        {
+            return false;
+        }
+        job = it->second;
+        return true;
+    }
+
+    // Blocks until the job is finished. Returns false if the job is unknown.
+    bool wait(unsigned int id, ProverJob &job)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true)
+        {
+            auto it = jobs.find(id);
+            if (it == jobs.end())
+            {
+                return false;
+            }
+            if (it->second.isFinished())
+            {
+                job = it->second;
+                return true;
+            }
+            cvFinished.wait(lock);
+        }
+    }
+
+    // All jobs currently known to the queue, oldest first
+    std::vector<ProverJob> list() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::vector<ProverJob> result;
+        result.reserve(jobs.size());
+        for (const auto &pair : jobs)
+        {
+            result.push_back(pair.second);
+        }
+        return result;
+    }
+
+    unsigned int numPending() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return pending.size();
+    }
+
+    unsigned int getCapacity() const
+    {
+        return capacity;
+    }
+
+    // Wakes up the workers and fails all jobs that were not started yet.
+    // Jobs already taken by a worker are left to the worker to finish.
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+        while (!pending.empty())
+        {
+            markFinished(jobs[pending.front()], false, "Error: Prover server stopped!");
+            pending.pop_front();
+        }
+        cvPending.notify_all();
+        cvFinished.notify_all();
+    }
+
+  private:
+    void markFinished(ProverJob &job, bool success, const std::string &result)
+    {
+        job.status = success ? JobStatus::Done : JobStatus::Failed;
+        job.result = result;
+        job.finished = std::chrono::system_clock::now();
+
+        // Only keep the most recent finished jobs around
+        finishedOrder.push_back(job.id);
+        while (finishedOrder.size() > maxFinishedJobs)
+        {
+            jobs.erase(finishedOrder.front());
+            finishedOrder.pop_front();
+        }
+    }
+
+    const unsigned int capacity;
+    const unsigned int maxFinishedJobs;
+    unsigned int nextID;
+    bool stopped;
+
+    std::map<unsigned int, ProverJob> jobs;
+    std::deque<unsigned int> pending;
+    std::deque<unsigned int> finishedOrder;
+
+    mutable std::mutex mtx;
+    std::condition_variable cvPending;
+    std::condition_variable cvFinished;
+};
+
+// Unbounded blocking FIFO used to hand work over between pipeline stages.
+// The number of items in flight is bounded by the producers.
+template <typename T> class Channel
+{
+  public:
+    Channel() : closed(false)
+    {
+    }
+
+    void push(const T &value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        items.push_back(value);
+        cv.notify_one();
+    }
+
+    // Blocks until an item is available. Returns false once the channel is
+    // closed and all remaining items were consumed.
+    bool pop(T &value)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty())
+        {
+            return false;
+        }
+        value = items.front();
+        items.pop_front();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        cv.notify_all();
+    }
+
+  private:
+    bool closed;
+    std::deque<T> items;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+} // namespace Loopring
+
+#endif
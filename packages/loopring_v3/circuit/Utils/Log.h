@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+// Messages below LOG_MIN_LEVEL are removed at compile time, including the
+// evaluation of their arguments (0: debug, 1: info, 2: error, 3: nothing).
+// Defaults to debug for debug builds and info for NDEBUG builds.
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_NONE 3
+
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define LOG(level, message, val)                                                                                       \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (Loopring::Log::enabled(level))                                                                             \
+        {                                                                                                              \
+            Loopring::Log::write(level, message, val);                                                                 \
+        }                                                                                                              \
+    } while (false)
+
+namespace Loopring
+{
+
+enum class LogLevel
+{
+    Debug = LOG_LEVEL_DEBUG,
+    Info = LOG_LEVEL_INFO,
+    Error = LOG_LEVEL_ERROR,
+    None = LOG_LEVEL_NONE
+};
+
+static const LogLevel LogDebug = LogLevel::Debug;
+static const LogLevel LogInfo = LogLevel::Info;
+static const LogLevel LogError = LogLevel::Error;
+
+// Every thread formats its messages in its own buffer. Debug messages are
+// written to stdout in one go when the buffer is full, on flush() and when the
+// thread exits, so threads only take the stdout lock once per buffer instead
+// of once per message. Info and error messages are written immediately.
+class Log
+{
+  public:
+    static const size_t BUFFER_SIZE = 16 * 1024;
+
+    static constexpr bool compiled(LogLevel level)
+    {
+        return int(level) >= LOG_MIN_LEVEL && level != LogLevel::None;
+    }
+
+    static bool enabled(LogLevel level)
+    {
+        return compiled(level) && int(level) >= int(minLevel());
+    }
+
+    // Changes the minimum level at runtime (not thread-safe, set it at startup).
+    // Levels removed at compile time stay disabled.
+    static void setLevel(LogLevel level)
+    {
+        minLevel() = level;
+    }
+
+    template <typename T> static void write(LogLevel level, const char *message, const T &val)
+    {
+        Buffer &buffer = threadBuffer();
+        std::ostringstream line;
+        line << toString(level) << ":" << message << ":" << val << "\n";
+        buffer.data += line.str();
+        if (level != LogLevel::Debug || buffer.data.size() >= BUFFER_SIZE)
+        {
+            buffer.flush();
+        }
+    }
+
+    // Writes the messages buffered by the calling thread
+    static void flush()
+    {
+        threadBuffer().flush();
+    }
+
+    static const char *toString(LogLevel level)
+    {
+        switch (level)
+        {
+        case LogLevel::Debug:
+            return "Debug";
+        case LogLevel::Info:
+            return "Info";
+        case LogLevel::Error:
+            return "Error";
+        default:
+            return "None";
+        }
+    }
+
+  private:
+    struct Buffer
+    {
+        std::string data;
+
+        ~Buffer()
+        {
+            flush();
+        }
+
+        void flush()
+        {
+            if (!data.empty())
+            {
+                std::lock_guard<std::mutex> lock(outputMutex());
+                fwrite(data.data(), 1, data.size(), stdout);
+                fflush(stdout);
+                data.clear();
+            }
+        }
+    };
+
+    static Buffer &threadBuffer()
+    {
+        static thread_local Buffer buffer;
+        return buffer;
+    }
+
+    static std::mutex &outputMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static LogLevel &minLevel()
+    {
+        static LogLevel level = LogLevel(LOG_MIN_LEVEL);
+        return level;
+    }
+};
+
+} // namespace Loopring
+
+#endif
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Loopring
+{
+
+// Exact decimal representation of the value: integers as is, other values with
+// the fewest digits that read back as the same double. The default stream
+// precision (6 digits) would print large counters and gauges (e.g. memory in
+// bytes) rounded in scientific notation.
+static std::string formatMetricValue(double value)
+{
+    // Integers up to 2^53 are exact in a double
+    if (std::fabs(value) < 9007199254740992.0 && value == std::floor(value))
+    {
+        return std::to_string(int64_t(value));
+    }
+    std::ostringstream out;
+    for (int precision = 6; precision < 17; precision++)
+    {
+        out.str("");
+        out << std::setprecision(precision) << value;
+        if (std::strtod(out.str().c_str(), nullptr) == value)
+        {
+            return out.str();
+        }
+    }
+    out.str("");
+    out << std::setprecision(17) << value;
+    return out.str();
+}
+
+class Counter
+{
+  public:
+    Counter() : value(0)
+    {
+    }
+
+    void inc(double amount = 1)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        value += amount;
+    }
+
+    double get() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return value;
+    }
+
+  private:
+    double value;
+    mutable std::mutex mtx;
+};
+
+// Cumulative histogram with fixed bucket upper bounds (the +Inf bucket is implicit)
+class Histogram
+{
+  public:
+    Histogram(const std::vector<double> &_bounds) : bounds(_bounds), counts(_bounds.size() + 1, 0), sum(0), count(0)
+    {
+    }
+
+    void observe(double value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        unsigned int i = 0;
+        while (i < bounds.size() && value > bounds[i])
+        {
+            i++;
+        }
+        counts[i]++;
+        sum += value;
+        count++;
+    }
+
+    void render(std::ostream &out, const std::string &name, const std::string &labels) const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        const std::string prefix = labels.empty() ? "" : labels + ",";
+        uint64_t cumulative = 0;
+        for (unsigned int i = 0; i < bounds.size(); i++)
+        {
+            cumulative += counts[i];
+            out << name << "_bucket{" << prefix << "le=\"" << formatMetricValue(bounds[i]) << "\"} " << cumulative
+                << "\n";
+        }
+        cumulative += counts.back();
+        out << name << "_bucket{" << prefix << "le=\"+Inf\"} " << cumulative << "\n";
+        const std::string braces = labels.empty() ? "" : "{" + labels + "}";
+        out << name << "_sum" << braces << " " << formatMetricValue(sum) << "\n";
+        out << name << "_count" << braces << " " << count << "\n";
+    }
+
+  private:
+    const std::vector<double> bounds;
+    std::vector<uint64_t> counts;
+    double sum;
+    uint64_t count;
+    mutable std::mutex mtx;
+};
+
+// Set of metrics rendered in the Prometheus text exposition format.
+// Metrics are created up front and live as long as the registry.
+// `labels` is a preformatted label list, e.g. `result="done"`.
+class MetricsRegistry
+{
+  public:
+    Counter &counter(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Family &family = getFamily(name, help, "counter");
+        family.counters.emplace_back(labels, std::unique_ptr<Counter>(new Counter()));
+        return *family.counters.back().second;
+    }
+
+    Histogram &histogram(
+      const std::string &name,
+      const std::string &help,
+      const std::vector<double> &bounds,
+      const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Family &family = getFamily(name, help, "histogram");
+        family.histograms.emplace_back(labels, std::unique_ptr<Histogram>(new Histogram(bounds)));
+        return *family.histograms.back().second;
+    }
+
+    // Gauges are sampled when rendering
+    void gauge(
+      const std::string &name,
+      const std::string &help,
+      const std::function<double()> &sample,
+      const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Family &family = getFamily(name, help, "gauge");
+        family.gauges.emplace_back(labels, sample);
+    }
+
+    std::string render() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ostringstream out;
+        for (const std::string &name : order)
+        {
+            const Family &family = families.at(name);
+            out << "# HELP " << name << " " << family.help << "\n";
+            out << "# TYPE " << name << " " << family.type << "\n";
+            for (const auto &counter : family.counters)
+            {
+                out << name << withBraces(counter.first) << " " << formatMetricValue(counter.second->get()) << "\n";
+            }
+            for (const auto &gauge : family.gauges)
+            {
+                out << name << withBraces(gauge.first) << " " << formatMetricValue(gauge.second()) << "\n";
+            }
+            for (const auto &histogram : family.histograms)
+            {
+                histogram.second->render(out, name, histogram.first);
+            }
+        }
+        return out.str();
+    }
+
+  private:
+    struct Family
+    {
+        std::string help;
+        std::string type;
+        std::vector<std::pair<std::string, std::unique_ptr<Counter>>> counters;
+        std::vector<std::pair<std::string, std::unique_ptr<Histogram>>> histograms;
+        std::vector<std::pair<std::string, std::function<double()>>> gauges;
+    };
+
+    Family &getFamily(const std::string &name, const std::string &help, const std::string &type)
+    {
+        auto it = families.find(name);
+        if (it == families.end())
+        {
+            order.push_back(name);
+            Family &family = families[name];
+            family.help = help;
+            family.type = type;
+            return family;
+        }
+        return it->second;
+    }
+
+    static std::string withBraces(const std::string &labels)
+    {
+        return labels.empty() ? "" : "{" + labels + "}";
+    }
+
+    std::map<std::string, Family> families;
+    std::vector<std::string> order;
+    mutable std::mutex mtx;
+};
+
+} // namespace Loopring
+
+#endif
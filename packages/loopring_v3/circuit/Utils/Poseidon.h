@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _POSEIDON_H_
+#define _POSEIDON_H_
+
+#include "Blake2b.h"
+#include "UInt256.h"
+
+#include "ethsnarks.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Loopring
+{
+
+// Native Poseidon hash with the parameters of ethsnarks' Poseidon_gadget_T
+// (x^5 S-box, round constants and Cauchy MDS matrix derived from the seed
+// "poseidon" with BLAKE2b). Computes the same outputs as the gadget without
+// a protoboard, e.g. to check Merkle paths before building the witness.
+//
+// hashBatch evaluates many independent hashes: the permutations are
+// interleaved LANES at a time so the field multiplications of the different
+// lanes don't depend on each other, and with MULTICORE the batch is split
+// over the threads.
+template <unsigned int t, unsigned int nRoundsF, unsigned int nRoundsP> class PoseidonPermutation
+{
+  public:
+    static const unsigned int NUM_ROUNDS = nRoundsF + nRoundsP;
+    static const unsigned int LANES = 4;
+
+    // Hash of 1 up to t - 1 inputs
+    static ethsnarks::FieldT hash(const std::vector<ethsnarks::FieldT> &inputs)
+    {
+        ethsnarks::FieldT output;
+        hash(inputs.data(), inputs.size(), &output, 1);
+        return output;
+    }
+
+    static void hash(
+      const ethsnarks::FieldT *inputs,
+      unsigned int numInputs,
+      ethsnarks::FieldT *outputs,
+      unsigned int numOutputs)
+    {
+        assert(numInputs > 0 && numInputs < t && numOutputs <= t);
+        ethsnarks::FieldT state[1][t];
+        load(state[0], inputs, numInputs);
+        permute<1>(state);
+        for (unsigned int i = 0; i < numOutputs; i++)
+        {
+            outputs[i] = state[0][i];
+        }
+    }
+
+    // `inputs` contains `numInputs` elements for every hash, outputs[i] is the
+    // (first) output of hash i
+    static void hashBatch(
+      const std::vector<ethsnarks::FieldT> &inputs,
+      unsigned int numInputs,
+      std::vector<ethsnarks::FieldT> &outputs)
+    {
+        assert(numInputs > 0 && numInputs < t && inputs.size() % numInputs == 0);
+        const unsigned int numHashes = inputs.size() / numInputs;
+        const unsigned int numGroups = (numHashes + LANES - 1) / LANES;
+        outputs.resize(numHashes);
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+        for (unsigned int group = 0; group < numGroups; group++)
+        {
+            const unsigned int first = group * LANES;
+            const unsigned int numLanes = (numHashes - first < LANES) ? numHashes - first : LANES;
+            ethsnarks::FieldT state[LANES][t];
+            for (unsigned int l = 0; l < LANES; l++)
+            {
+                // Unused lanes hash a copy of the first one
+                const unsigned int h = first + (l < numLanes ? l : 0);
+                load(state[l], &inputs[h * numInputs], numInputs);
+            }
+            permute<LANES>(state);
+            for (unsigned int l = 0; l < numLanes; l++)
+            {
+                outputs[first + l] = state[l][0];
+            }
+        }
+    }
+
+  private:
+    struct Params
+    {
+        ethsnarks::FieldT C[NUM_ROUNDS];
+        ethsnarks::FieldT M[t][t];
+
+        Params()
+        {
+            std::vector<ethsnarks::FieldT> constants = pseudoRandom("poseidon_constants", NUM_ROUNDS);
+            for (unsigned int i = 0; i < NUM_ROUNDS; i++)
+            {
+                C[i] = constants[i];
+            }
+            std::vector<ethsnarks::FieldT> matrix = pseudoRandom("poseidon_matrix_0000", 2 * t);
+            for (unsigned int i = 0; i < t; i++)
+            {
+                for (unsigned int j = 0; j < t; j++)
+                {
+                    M[i][j] = (matrix[i] - matrix[t + j]).inverse();
+                }
+            }
+        }
+    };
+
+    static const Params &params()
+    {
+        static const Params params;
+        return params;
+    }
+
+    // x_0 = H(seed), x_i = H(x_{i-1}), interpreted as little-endian integers mod p
+    static std::vector<ethsnarks::FieldT> pseudoRandom(const std::string &seed, unsigned int n)
+    {
+        UInt256 modulus;
+        memcpy(modulus.limbs, ethsnarks::FieldT::mod.data, ethsnarks::FieldT::num_limbs * sizeof(mp_limb_t));
+
+        std::vector<ethsnarks::FieldT> result;
+        std::vector<uint8_t> h = Blake2b::hash((const uint8_t *)seed.data(), seed.size());
+        while (result.size() < n)
+        {
+            UInt256 value;
+            memcpy(value.limbs, h.data(), 32);
+            value = value % modulus;
+            result.push_back(value.toFieldElement());
+            h = Blake2b::hash(h);
+        }
+        return result;
+    }
+
+    static void load(ethsnarks::FieldT *state, const ethsnarks::FieldT *inputs, unsigned int numInputs)
+    {
+        for (unsigned int i = 0; i < t; i++)
+        {
+            state[i] = (i < numInputs) ? inputs[i] : ethsnarks::FieldT::zero();
+        }
+    }
+
+    static void sbox(ethsnarks::FieldT &x)
+    {
+        ethsnarks::FieldT x2 = x * x;
+        x = x2 * x2 * x;
+    }
+
+    template <unsigned int lanes> static void permute(ethsnarks::FieldT (*state)[t])
+    {
+        const Params &p = params();
+        ethsnarks::FieldT mixed[t];
+        for (unsigned int r = 0; r < NUM_ROUNDS; r++)
+        {
+            const bool fullRound = (r < nRoundsF / 2) || (r >= nRoundsF / 2 + nRoundsP);
+            for (unsigned int j = 0; j < t; j++)
+            {
+                for (unsigned int l = 0; l < lanes; l++)
+                {
+                    state[l][j] += p.C[r];
+                }
+            }
+            for (unsigned int j = 0; j < (fullRound ? t : 1); j++)
+            {
+                for (unsigned int l = 0; l < lanes; l++)
+                {
+                    sbox(state[l][j]);
+                }
+            }
+            for (unsigned int l = 0; l < lanes; l++)
+            {
+                for (unsigned int i = 0; i < t; i++)
+                {
+                    mixed[i] = p.M[i][0] * state[l][0];
+                    for (unsigned int j = 1; j < t; j++)
+                    {
+                        mixed[i] += p.M[i][j] * state[l][j];
+                    }
+                }
+                for (unsigned int i = 0; i < t; i++)
+                {
+                    state[l][i] = mixed[i];
+                }
+            }
+        }
+    }
+};
+
+// Same parameters as the gadgets in MathGadgets.h
+using NativePoseidon_2 = PoseidonPermutation<3, 6, 51>;
+using NativePoseidon_4 = PoseidonPermutation<5, 6, 52>;
+using NativePoseidon_5 = PoseidonPermutation<6, 6, 52>;
+using NativePoseidon_6 = PoseidonPermutation<7, 6, 52>;
+using NativePoseidon_7 = PoseidonPermutation<8, 6, 53>;
+using NativePoseidon_8 = PoseidonPermutation<9, 6, 53>;
+using NativePoseidon_9 = PoseidonPermutation<10, 6, 53>;
+using NativePoseidon_10 = PoseidonPermutation<11, 6, 53>;
+using NativePoseidon_11 = PoseidonPermutation<12, 6, 53>;
+using NativePoseidon_12 = PoseidonPermutation<13, 6, 53>;
+using NativePoseidon_13 = PoseidonPermutation<14, 6, 53>;
+
+} // namespace Loopring
+
+#endif
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _TASKGRAPH_H_
+#define _TASKGRAPH_H_
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Loopring
+{
+
+// Runs tasks with dependencies between them. A task is started as soon as all
+// its dependencies are done. With MULTICORE the tasks are OpenMP tasks, which
+// the runtime distributes over the threads with work stealing. Ready tasks are
+// started heaviest first so long tasks don't end up at the tail.
+//
+// Dependencies need to be added before the tasks depending on them, so the
+// insertion order is a valid serial order.
+class TaskGraph
+{
+  public:
+    unsigned int add(
+      const std::string &name,
+      double weight,
+      const std::function<void()> &fn,
+      const std::vector<unsigned int> &dependencies = {})
+    {
+        unsigned int id = tasks.size();
+        tasks.push_back({name, weight, fn, dependencies, {}, 0.0});
+        for (unsigned int dependency : dependencies)
+        {
+            assert(dependency < id);
+            tasks[dependency].dependents.push_back(id);
+        }
+        return id;
+    }
+
+    // Runs all tasks, rethrows the first exception thrown by a task.
+    // Tasks depending on a failed task are not run.
+    void run()
+    {
+        auto begin = std::chrono::steady_clock::now();
+        remaining.resize(tasks.size());
+        std::vector<unsigned int> roots;
+        for (unsigned int i = 0; i < tasks.size(); i++)
+        {
+            remaining[i] = tasks[i].dependencies.size();
+            if (remaining[i] == 0)
+            {
+                roots.push_back(i);
+            }
+        }
+        error = nullptr;
+
+#ifdef MULTICORE
+#pragma omp parallel
+#pragma omp single
+        {
+            spawn(roots);
+        }
+#else
+        for (unsigned int i = 0; i < tasks.size(); i++)
+        {
+            if (remaining[i] == 0)
+            {
+                execute(i);
+            }
+        }
+#endif
+        wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Seconds spent in all tasks together
+    double getWorkTime() const
+    {
+        double total = 0.0;
+        for (const Task &task : tasks)
+        {
+            total += task.duration;
+        }
+        return total;
+    }
+
+    double getWallTime() const
+    {
+        return wallTime;
+    }
+
+    // The chain of dependent tasks that took the longest (by measured duration)
+    std::vector<unsigned int> getCriticalPath(double &duration) const
+    {
+        std::vector<double> pathTime(tasks.size(), 0.0);
+        std::vector<int> previous(tasks.size(), -1);
+        int last = -1;
+        for (unsigned int i = 0; i < tasks.size(); i++)
+        {
+            for (unsigned int dependency : tasks[i].dependencies)
+            {
+                if (previous[i] == -1 || pathTime[dependency] > pathTime[previous[i]])
+                {
+                    previous[i] = dependency;
+                }
+            }
+            pathTime[i] = tasks[i].duration + (previous[i] == -1 ? 0.0 : pathTime[previous[i]]);
+            if (last == -1 || pathTime[i] > pathTime[last])
+            {
+                last = i;
+            }
+        }
+
+        std::vector<unsigned int> path;
+        duration = (last == -1) ? 0.0 : pathTime[last];
+        for (int i = last; i != -1; i = previous[i])
+        {
+            path.push_back(i);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // e.g. "wall 1.2s, work 9.6s, critical path 0.9s: inputs -> tx_3 -> publicData"
+    std::string getStats() const
+    {
+        double criticalTime;
+        std::vector<unsigned int> path = getCriticalPath(criticalTime);
+        std::ostringstream out;
+        out << "wall " << wallTime << "s, work " << getWorkTime() << "s, critical path " << criticalTime << "s:";
+        for (unsigned int i = 0; i < path.size(); i++)
+        {
+            out << (i == 0 ? " " : " -> ") << tasks[path[i]].name;
+        }
+        return out.str();
+    }
+
+    const std::string &getName(unsigned int id) const
+    {
+        return tasks[id].name;
+    }
+
+    double getDuration(unsigned int id) const
+    {
+        return tasks[id].duration;
+    }
+
+  private:
+    struct Task
+    {
+        std::string name;
+        double weight;
+        std::function<void()> fn;
+        std::vector<unsigned int> dependencies;
+        std::vector<unsigned int> dependents;
+        double duration;
+    };
+
+    void execute(unsigned int id)
+    {
+        Task &task = tasks[id];
+        auto begin = std::chrono::steady_clock::now();
+        bool failed = false;
+        try
+        {
+            task.fn();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            failed = true;
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+        task.duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (failed)
+        {
+            return;
+        }
+
+        std::vector<unsigned int> ready;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (unsigned int dependent : task.dependents)
+            {
+                if (--remaining[dependent] == 0)
+                {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+#ifdef MULTICORE
+        spawn(ready);
+#endif
+    }
+
+#ifdef MULTICORE
+    void spawn(std::vector<unsigned int> ready)
+    {
+        std::stable_sort(ready.begin(), ready.end(), [this](unsigned int a, unsigned int b) {
+            return tasks[a].weight > tasks[b].weight;
+        });
+        for (unsigned int id : ready)
+        {
+#pragma omp task firstprivate(id)
+            execute(id);
+        }
+    }
+#endif
+
+    std::vector<Task> tasks;
+    std::vector<unsigned int> remaining;
+    std::exception_ptr error;
+    double wallTime = 0.0;
+    std::mutex mtx;
+};
+
+} // namespace Loopring
+
+#endif
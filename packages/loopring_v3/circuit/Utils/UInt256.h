@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2017 Loopring Technology Limited.
+// Modified by DeGate DAO, 2022
+#ifndef _UINT256_H_
+#define _UINT256_H_
+
+#include "ethsnarks.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace Loopring
+{
+
+// Fixed-width 256-bit unsigned integer for the integer math done while
+// generating the witness (divisions, float encoding, ...). Converts directly
+// from/to the limbs of a field element, no string round trips.
+// Arithmetic wraps around modulo 2^256 unless stated otherwise.
+class UInt256
+{
+  public:
+    static const unsigned int NUM_LIMBS = 4;
+
+    // Little-endian 64-bit limbs
+    uint64_t limbs[NUM_LIMBS];
+
+    UInt256(uint64_t value = 0)
+    {
+        limbs[0] = value;
+        for (unsigned int i = 1; i < NUM_LIMBS; i++)
+        {
+            limbs[i] = 0;
+        }
+    }
+
+    explicit UInt256(const ethsnarks::FieldT &value)
+    {
+        static_assert(
+          ethsnarks::FieldT::num_limbs * sizeof(mp_limb_t) <= sizeof(limbs), "Field element does not fit 256 bits");
+        const auto bigint = value.as_bigint();
+        memset(limbs, 0, sizeof(limbs));
+        memcpy(limbs, bigint.data, ethsnarks::FieldT::num_limbs * sizeof(mp_limb_t));
+    }
+
+    // The value needs to be smaller than the field modulus
+    ethsnarks::FieldT toFieldElement() const
+    {
+        libff::bigint<ethsnarks::FieldT::num_limbs> bigint;
+        memcpy(bigint.data, limbs, ethsnarks::FieldT::num_limbs * sizeof(mp_limb_t));
+        return ethsnarks::FieldT(bigint);
+    }
+
+    uint64_t toUint64() const
+    {
+        return limbs[0];
+    }
+
+    bool isZero() const
+    {
+        for (unsigned int i = 0; i < NUM_LIMBS; i++)
+        {
+            if (limbs[i] != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    unsigned int numBits() const
+    {
+        for (unsigned int i = NUM_LIMBS; i > 0; i--)
+        {
+            if (limbs[i - 1] != 0)
+            {
+                return (i - 1) * 64 + (64 - __builtin_clzll(limbs[i - 1]));
+            }
+        }
+        return 0;
+    }
+
+    bool testBit(unsigned int bit) const
+    {
+        return (limbs[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    int compare(const UInt256 &other) const
+    {
+        for (unsigned int i = NUM_LIMBS; i > 0; i--)
+        {
+            if (limbs[i - 1] != other.limbs[i - 1])
+            {
+                return limbs[i - 1] < other.limbs[i - 1] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    bool operator==(const UInt256 &other) const
+    {
+        return compare(other) == 0;
+    }
+    bool operator!=(const UInt256 &other) const
+    {
+        return compare(other) != 0;
+    }
+    bool operator<(const UInt256 &other) const
+    {
+        return compare(other) < 0;
+    }
+    bool operator<=(const UInt256 &other) const
+    {
+        return compare(other) <= 0;
+    }
+    bool operator>(const UInt256 &other) const
+    {
+        return compare(other) > 0;
+    }
+    bool operator>=(const UInt256 &other) const
+    {
+        return compare(other) >= 0;
+    }
+
+    UInt256 operator+(const UInt256 &other) const
+    {
+        UInt256 result;
+        unsigned __int128 carry = 0;
+        for (unsigned int i = 0; i < NUM_LIMBS; i++)
+        {
+            carry += (unsigned __int128)limbs[i] + other.limbs[i];
+            result.limbs[i] = uint64_t(carry);
+            carry >>= 64;
+        }
+        return result;
+    }
+
+    UInt256 operator-(const UInt256 &other) const
+    {
+        UInt256 result;
+        uint64_t borrow = 0;
+        for (unsigned int i = 0; i < NUM_LIMBS; i++)
+        {
+            uint64_t a = limbs[i];
+            uint64_t b = other.limbs[i];
+            result.limbs[i] = a - b - borrow;
+            borrow = (a < b || (a == b && borrow)) ? 1 : 0;
+        }
+        return result;
+    }
+
+    // Returns true when the result did not fit in 256 bits
+    static bool mulOverflow(const UInt256 &a, const UInt256 &b, UInt256 &result)
+    {
+        uint64_t product[2 * NUM_LIMBS] = {0};
+        for (unsigned int i = 0; i < NUM_LIMBS; i++)
+        {
+            unsigned __int128 carry = 0;
+            for (unsigned int j = 0; j < NUM_LIMBS; j++)
+            {
+                carry += (unsigned __int128)a.limbs[i] * b.limbs[j] + product[i + j];
+                product[i + j] = uint64_t(carry);
+                carry >>= 64;
+            }
+            product[i + NUM_LIMBS] = uint64_t(carry);
+        }
+        bool overflow = false;
+        for (unsigned int i = 0; i < NUM_LIMBS; i++)
+        {
+            result.limbs[i] = product[i];
+            overflow = overflow || (product[i + NUM_LIMBS] != 0);
+        }
+        return overflow;
+    }
+
+    UInt256 operator*(const UInt256 &other) const
+    {
+        UInt256 result;
+        mulOverflow(*this, other, result);
+        return result;
+    }
+
+    UInt256 operator<<(unsigned int shift) const
+    {
+        UInt256 result;
+        if (shift >= 256)
+        {
+            return result;
+        }
+        const unsigned int limbShift = shift / 64;
+        const unsigned int bitShift = shift % 64;
+        for (unsigned int i = NUM_LIMBS; i > limbShift; i--)
+        {
+            const unsigned int j = i - 1 - limbShift;
+            uint64_t value = limbs[j] << bitShift;
+            if (bitShift != 0 && j > 0)
+            {
+                value |= limbs[j - 1] >> (64 - bitShift);
+            }
+            result.limbs[i - 1] = value;
+        }
+        return result;
+    }
+
+    UInt256 operator>>(unsigned int shift) const
+    {
+        UInt256 result;
+        if (shift >= 256)
+        {
+            return result;
+        }
+        const unsigned int limbShift = shift / 64;
+        const unsigned int bitShift = shift % 64;
+        for (unsigned int i = 0; i + limbShift < NUM_LIMBS; i++)
+        {
+            const unsigned int j = i + limbShift;
+            uint64_t value = limbs[j] >> bitShift;
+            if (bitShift != 0 && j + 1 < NUM_LIMBS)
+            {
+                value |= limbs[j + 1] << (64 - bitShift);
+            }
+            result.limbs[i] = value;
+        }
+        return result;
+    }
+
+    static void divmod(const UInt256 &a, const UInt256 &b, UInt256 &quotient, UInt256 &remainder)
+    {
+        assert(!b.isZero());
+        quotient = UInt256();
+        // Fast path for divisors that fit in a single limb
+        if (b.numBits() <= 64)
+        {
+            const uint64_t divisor = b.limbs[0];
+            unsigned __int128 rem = 0;
+            for (unsigned int i = NUM_LIMBS; i > 0; i--)
+            {
+                rem = (rem << 64) | a.limbs[i - 1];
+                quotient.limbs[i - 1] = uint64_t(rem / divisor);
+                rem = rem % divisor;
+            }
+            remainder = UInt256(uint64_t(rem));
+            return;
+        }
+        // Shift-subtract, only over the bits the quotient can have
+        remainder = a;
+        if (a < b)
+        {
+            return;
+        }
+        const unsigned int shift = a.numBits() - b.numBits();
+        UInt256 divisor = b << shift;
+        for (unsigned int i = shift + 1; i > 0; i--)
+        {
+            if (remainder >= divisor)
+            {
+                remainder = remainder - divisor;
+                quotient.limbs[(i - 1) / 64] |= uint64_t(1) << ((i - 1) % 64);
+            }
+            divisor = divisor >> 1;
+        }
+    }
+
+    UInt256 operator/(const UInt256 &other) const
+    {
+        UInt256 quotient, remainder;
+        divmod(*this, other, quotient, remainder);
+        return quotient;
+    }
+
+    UInt256 operator%(const UInt256 &other) const
+    {
+        UInt256 quotient, remainder;
+        divmod(*this, other, quotient, remainder);
+        return remainder;
+    }
+};
+
+} // namespace Loopring
+
+#endif
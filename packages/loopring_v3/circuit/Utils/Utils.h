@@ -6,8 +6,9 @@
 
 #include "Constants.h"
 #include "Data.h"
+#include "Log.h"
+#include "UInt256.h"
 
-#include "../ThirdParty/BigIntHeader.hpp"
 #include "ethsnarks.hpp"
 #include "gadgets/merkle_tree.hpp"
 #include "gadgets/sha256_many.hpp"
@@ -40,18 +41,6 @@
     } while (false)
 #endif
 
-
-#ifndef NDEBUG
-#define LOG(level, message, val)                                                                                       \
-    std::cout << level << ":" << message << ":" << val << std::endl;                                                   
-#else
-#define LOG(level, message, val)                                                                                       \
-    if ("Error" == level || "Info" == level)                                                                           \
-    {                                                                                                                  \
-        std::cout << level << ":" << message << ":" << val << std::endl;                                               \
-    }                                                                                                        
-#endif
-
 using namespace ethsnarks;
 
 namespace Loopring
@@ -89,6 +78,25 @@ static void printBits(const char *name, const libff::bit_vector &_bits, bool rev
     delete[] hexstr;
 }
 
+static std::string toHexString(const uint8_t *bytes, size_t size)
+{
+    std::string hexstr(size * 2, '0');
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < size; i++)
+    {
+        hexstr[i * 2] = digits[bytes[i] >> 4];
+        hexstr[i * 2 + 1] = digits[bytes[i] & 0xf];
+    }
+    return "0x" + hexstr;
+}
+
+static std::string toHexString(const libff::bit_vector &bits)
+{
+    std::vector<uint8_t> bytes((bits.size() + 7) / 8, 0);
+    bv_to_bytes(bits, bytes.data());
+    return toHexString(bytes.data(), bits.size() / 8);
+}
+
 /**
  * Convert an array of variable arrays into a flat contiguous array of variables
  */
@@ -172,65 +180,59 @@ static const std::vector<VariableT> threeVariable_to_vector(const VariableT &one
     return result;
 }
 
-static BigInt toBigInt(ethsnarks::FieldT _value, bool sign = true)
-{
-    auto value = _value.as_bigint();
-    BigInt bi = 0;
-    for (unsigned int i = 0; i < value.num_bits(); i++)
-    {
-        bi = bi * 2 + (value.test_bit(value.num_bits() - 1 - i) ? 1 : 0);
-    }
-    if (!sign)
-    {
-        bi = -bi;
-    }
-    return bi;
-}
-
-static unsigned int toFloat(BigInt value, const FloatEncoding &encoding)
+static unsigned int toFloat(const UInt256 &value, const FloatEncoding &encoding)
 {
     const unsigned int maxExponent = (1 << encoding.numBitsExponent) - 1;
     const unsigned int maxMantissa = (1 << encoding.numBitsMantissa) - 1;
-    BigInt maxExponentValue = 1;
-    for (unsigned int i = 0; i < maxExponent; i++)
+#ifndef NDEBUG
+    // The max value does not fit in 256 bits for the larger exponents, all values are valid then
+    UInt256 maxValue = maxMantissa;
+    bool maxValueOverflow = false;
+    for (unsigned int i = 0; i < maxExponent && !maxValueOverflow; i++)
     {
-        maxExponentValue *= encoding.exponentBase;
+        maxValueOverflow = UInt256::mulOverflow(maxValue, encoding.exponentBase, maxValue);
     }
-    BigInt maxValue = BigInt(maxMantissa) * BigInt(maxExponentValue);
-    assert(value <= maxValue);
+    assert(maxValueOverflow || value <= maxValue);
+#endif
 
     unsigned int exponent = 0;
-    BigInt r = value / BigInt(maxMantissa);
-    BigInt d = 1;
-    while (r >= encoding.exponentBase || d * maxMantissa < value)
+    UInt256 r = value / maxMantissa;
+    UInt256 d = 1;
+    UInt256 dMaxMantissa = maxMantissa;
+    while (r >= encoding.exponentBase || dMaxMantissa < value)
     {
         r = r / encoding.exponentBase;
         exponent += 1;
         d = d * encoding.exponentBase;
+        // Once d * maxMantissa does not fit in 256 bits it is larger than any value
+        if (UInt256::mulOverflow(d, maxMantissa, dMaxMantissa))
+        {
+            dMaxMantissa = value;
+        }
     }
-    BigInt mantissa = value / d;
+    UInt256 mantissa = value / d;
 
     assert(exponent <= maxExponent);
     assert(mantissa <= maxMantissa);
-    const unsigned int f = (exponent << encoding.numBitsMantissa) + mantissa.to_long();
+    const unsigned int f = (exponent << encoding.numBitsMantissa) + mantissa.toUint64();
     return f;
 }
 
 static unsigned int toFloat(ethsnarks::FieldT value, const FloatEncoding &encoding)
 {
-    return toFloat(toBigInt(value), encoding);
+    return toFloat(UInt256(value), encoding);
 }
 
-static BigInt fromFloat(unsigned int f, const FloatEncoding &encoding)
+static UInt256 fromFloat(unsigned int f, const FloatEncoding &encoding)
 {
     const unsigned int exponent = f >> encoding.numBitsMantissa;
     const unsigned int mantissa = f & ((1 << encoding.numBitsMantissa) - 1);
-    BigInt multiplier = 1;
+    UInt256 multiplier = 1;
     for (unsigned int i = 0; i < exponent; i++)
     {
-        multiplier *= 10;
+        multiplier = multiplier * 10;
     }
-    BigInt value = BigInt(mantissa) * multiplier;
+    UInt256 value = UInt256(mantissa) * multiplier;
     return value;
 }
 
@@ -238,7 +240,7 @@ static FieldT roundToFloatValue(const FieldT &value, const FloatEncoding &encodi
 {
     auto f = toFloat(value, encoding);
     auto floatValue = fromFloat(f, encoding);
-    return FieldT(floatValue.to_string().c_str());
+    return floatValue.toFieldElement();
 }
 
 } // namespace Loopring
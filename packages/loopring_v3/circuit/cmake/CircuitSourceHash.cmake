@@ -0,0 +1,34 @@
+# Writes OUTPUT, a header defining CIRCUIT_SOURCE_HASH: the hash of all sources the
+# constraint system is built from (the circuit and the ethsnarks/libsnark gadgets).
+# Runs on every build (cmake -P) so the hash always matches the binary, but only
+# rewrites the header when the hash changes.
+file(GLOB circuit_sources
+    "${CIRCUIT_DIR}/main.cpp"
+    "${CIRCUIT_DIR}/Circuits/*.h"
+    "${CIRCUIT_DIR}/Gadgets/*.h"
+    "${CIRCUIT_DIR}/Utils/*.h"
+)
+file(GLOB_RECURSE ethsnarks_sources
+    "${ETHSNARKS_DIR}/src/*.hpp"
+    "${ETHSNARKS_DIR}/src/*.cpp"
+    "${ETHSNARKS_DIR}/depends/libsnark/libsnark/gadgetlib1/*.hpp"
+    "${ETHSNARKS_DIR}/depends/libsnark/libsnark/gadgetlib1/*.tcc"
+)
+set(sources ${circuit_sources} ${ethsnarks_sources})
+list(SORT sources)
+
+set(sources_hashes "")
+foreach(source ${sources})
+  file(SHA256 ${source} source_hash)
+  string(APPEND sources_hashes ${source_hash})
+endforeach()
+string(SHA256 source_hash "${sources_hashes}")
+
+set(header "// Generated by cmake/CircuitSourceHash.cmake\n#define CIRCUIT_SOURCE_HASH \"${source_hash}\"\n")
+set(previous_header "")
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" previous_header)
+endif()
+if(NOT previous_header STREQUAL header)
+  file(WRITE "${OUTPUT}" "${header}")
+endif()
@@ -2,8 +2,16 @@
 // Copyright 2017 Loopring Technology Limited.
 // Modified by DeGate DAO, 2022
 
-#include "ThirdParty/BigInt.hpp"
 #include "Utils/Data.h"
+#include "Utils/JobQueue.h"
+#include "Utils/BulkProvingKey.h"
+#include "Utils/ConstraintSystemCache.h"
+#include "Utils/ConstraintChecker.h"
+#include "Utils/BinaryBlock.h"
+#include "Utils/BlockPrecheck.h"
+#include "Utils/BlockPadding.h"
+#include "Utils/CircuitStats.h"
+#include "Utils/Metrics.h"
 #include "Circuits/UniversalCircuit.h"
 
 #include "ThirdParty/httplib.h"
@@ -14,18 +22,29 @@
 #include <fstream>
 #include <chrono>
 #include <mutex>
+#include <thread>
+#include <memory>
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
 #include <exception>
 #include <pthread.h>
 #include <unistd.h>
+#include <dirent.h>
 
 #ifdef MULTICORE
 #include <omp.h>
 #endif
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 #define WITH_MEMORY_STATS 0
 
+// Maximum number of blocks waiting to be proven in server mode
+static const unsigned int DEFAULT_SERVER_QUEUE_SIZE = 16;
+
 #if WITH_MEMORY_STATS
 #include <unistd.h>
 #include <ios>
@@ -91,7 +110,49 @@ void printMemoryUsage()
 }
 #endif
 
+// Resident set size of the process in MB (0 if unknown)
+unsigned int getResidentMemoryMB()
+{
+    std::ifstream statm("/proc/self/statm");
+    unsigned long size = 0, resident = 0;
+    if (!(statm >> size >> resident))
+    {
+        return 0;
+    }
+    return (unsigned long long)resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+// Number of threads of the process (0 if unknown)
+unsigned int getNumThreads()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 8, "Threads:") == 0)
+        {
+            return std::strtoul(line.c_str() + 8, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// Gives freed memory back to the OS
+void trimMemory()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
 using json = nlohmann::json;
+using Loopring::Channel;
+using Loopring::JobQueue;
+using Loopring::JobStatus;
+using Loopring::ProofCheck;
+using Loopring::ProverJob;
+using Loopring::jobStatusToString;
+using Loopring::proofCheckToString;
 
 enum class Mode
 {
@@ -102,7 +163,10 @@ enum class Mode
     ExportWitness,
     Server,
     Benchmark,
-	Test
+	Test,
+    Precheck,
+    CircuitStats,
+    SelectSize
 };
 
 namespace libsnark
@@ -177,6 +241,75 @@ static void from_json(const nlohmann::json &j, BenchmarkConfig &config)
     config.multi_exp_look_ahead = j.at("multi_exp_look_ahead").get<std::vector<unsigned int>>();
 }
 
+// When the server verifies the proofs it generates
+enum class VerifyMode
+{
+    // Before returning the proof
+    Sync = 0,
+    // On a separate thread, the proof is returned immediately. The job stays done, the
+    // result is reported in the `verification` field of /job ("verified" or "verify_failed").
+    Async,
+    Off
+};
+
+struct ServerConfig
+{
+    unsigned int queue_size = DEFAULT_SERVER_QUEUE_SIZE;
+    // Circuits per block size (2 generates the next witness while proving)
+    unsigned int num_circuits = 1;
+    // Block sizes loaded at startup (the size of the block passed on the command line is always loaded)
+    std::vector<unsigned int> block_sizes;
+    // Idle block sizes are unloaded to stay below this limit (0: no limit)
+    unsigned int memory_budget_mb = 0;
+    VerifyMode verify_mode = VerifyMode::Sync;
+    // Rejects blocks that fail the native precheck before generating the witness
+    bool precheck = false;
+};
+
+static void from_json(const nlohmann::json &j, ServerConfig &config)
+{
+    if (j.contains("queue_size"))
+    {
+        config.queue_size = j.at("queue_size").get<unsigned int>();
+    }
+    if (j.contains("num_circuits"))
+    {
+        config.num_circuits = std::max(1u, j.at("num_circuits").get<unsigned int>());
+    }
+    if (j.contains("block_sizes"))
+    {
+        config.block_sizes = j.at("block_sizes").get<std::vector<unsigned int>>();
+    }
+    if (j.contains("memory_budget_mb"))
+    {
+        config.memory_budget_mb = j.at("memory_budget_mb").get<unsigned int>();
+    }
+    if (j.contains("precheck"))
+    {
+        config.precheck = j.at("precheck").get<bool>();
+    }
+    if (j.contains("verify_mode"))
+    {
+        std::string verifyMode = j.at("verify_mode").get<std::string>();
+        if (verifyMode == "sync")
+        {
+            config.verify_mode = VerifyMode::Sync;
+        }
+        else if (verifyMode == "async")
+        {
+            config.verify_mode = VerifyMode::Async;
+        }
+        else if (verifyMode == "off")
+        {
+            config.verify_mode = VerifyMode::Off;
+        }
+        else
+        {
+            throw std::runtime_error("Invalid verify_mode: " + verifyMode);
+        }
+    }
+}
+
 static inline auto now() -> decltype(std::chrono::high_resolution_clock::now())
 {
     return std::chrono::high_resolution_clock::now();
@@ -189,6 +322,12 @@ template <typename T> unsigned int elapsed_time_ms(const T &t1)
     return time_ms;
 }
 
+template <typename T> double elapsed_time_s(const T &t1)
+{
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(t2 - t1).count();
+}
+
 template <typename T> void print_time(const T &t1, const char *str)
 {
     printf("%s (%dms)\n", str, elapsed_time_ms(t1));
@@ -250,6 +389,73 @@ json loadJSON(const std::string &filename)
     return input;
 }
 
+// A block to prove, either a block.json or a binary block (see -block2bin).
+// A block size of 0 proves the block with the smallest available block size (see padBlockInput).
+struct BlockInput
+{
+    bool binary = false;
+    // `block` is used instead of `jBlock` (binary and padded blocks)
+    bool parsed = false;
+    json jBlock;
+    Loopring::Block block;
+    unsigned int blockType = 0;
+    unsigned int blockSize = 0;
+};
+
+bool loadBlockInput(const std::string &filename, BlockInput &input)
+{
+    if (Loopring::isBinaryBlock(filename))
+    {
+        input.binary = true;
+        input.parsed = true;
+        return Loopring::readBinaryBlock(filename, input.block, input.blockType, input.blockSize);
+    }
+    input.binary = false;
+    input.parsed = false;
+    input.jBlock = loadJSON(filename);
+    if (input.jBlock == json())
+    {
+        return false;
+    }
+    input.blockType = input.jBlock["blockType"].get<int>();
+    input.blockSize = input.jBlock["blockSize"].get<int>();
+    return true;
+}
+
+bool block2bin(const std::string &jsonFilename, const std::string &binFilename)
+{
+    BlockInput input;
+    if (!loadBlockInput(jsonFilename, input) || input.binary)
+    {
+        return false;
+    }
+    Loopring::Block block = input.jBlock.get<Loopring::Block>();
+    return Loopring::writeBinaryBlock(block, input.blockType, input.blockSize, binFilename);
+}
+
+// Checks the Merkle proofs and the state roots of the block without building the circuit
+Loopring::PrecheckResult precheckBlock(const BlockInput &input)
+{
+    if (input.parsed)
+    {
+        return Loopring::BlockPrecheck::check(input.block);
+    }
+    return Loopring::BlockPrecheck::check(input.jBlock.get<Loopring::Block>());
+}
+
+std::string precheckResultToString(const Loopring::PrecheckResult &result)
+{
+    if (result.valid)
+    {
+        return "valid";
+    }
+    if (result.transaction < 0)
+    {
+        return "block: " + result.error;
+    }
+    return "transaction " + std::to_string(result.transaction) + ": " + result.error;
+}
+
 libsnark::Config loadConfig(const std::string &filename)
 {
     return loadJSON(filename).get<libsnark::Config>();
@@ -259,6 +465,15 @@ void loadProvingKey(const std::string &pk_file, ethsnarks::ProvingKeyT &proving_
 {
     std::cout << "Loading proving key " << pk_file << "..." << std::endl;
     auto begin = now();
+    if (Loopring::isBulkProvingKey(pk_file))
+    {
+        if (!Loopring::readBulkProvingKey(pk_file, proving_key))
+        {
+            throw std::runtime_error("Failed to load proving key " + pk_file);
+        }
+        print_time(begin, "Proving key loaded");
+        return;
+    }
     auto pk = ethsnarks::load_proving_key(pk_file.c_str());
     proving_key.alpha_g1 = std::move(pk.alpha_g1);
     proving_key.beta_g1 = std::move(pk.beta_g1);
@@ -282,11 +497,12 @@ std::string proveCircuit(ProverContextT &context, Loopring::Circuit *circuit)
 {
     std::cout << "Generating proof..." << std::endl;
     auto begin = now();
-    std::string jProof = ethsnarks::prove(context, circuit->getPb());
+    std::string jProof = ethsnarks::prove(context, circuit->getProvingPb());
     unsigned int elapsed_ms = elapsed_time_ms(begin);
     elapsed_ms = elapsed_ms == 0 ? 1 : elapsed_ms;
     std::cout << "Proof generated in " << float(elapsed_ms) / 1000.0f << " seconds ("
-              << (circuit->getPb().num_constraints() * 10) / (elapsed_ms / 100) << " constraints/second)" << std::endl;
+              << (circuit->getProvingPb().num_constraints() * 10) / (elapsed_ms / 100) << " constraints/second)"
+              << std::endl;
     return jProof;
 }
 
@@ -298,230 +514,1050 @@ bool writeProof(const std::string &jProof, const std::string &proofFilename)
         std::cerr << "Cannot create proof file: " << proofFilename << std::endl;
         return false;
     }
-    fproof << jProof;
-    fproof.close();
-    std::cout << "Proof written to: " << proofFilename << std::endl;
-    return true;
-}
+    fproof << jProof;
+    fproof.close();
+    std::cout << "Proof written to: " << proofFilename << std::endl;
+    return true;
+}
+
+Loopring::Circuit *newCircuit(unsigned int blockType, ethsnarks::ProtoboardT &outPb)
+{
+    // The block type only selects the layout of the transaction slots
+    return new Loopring::UniversalCircuit(outPb, blockType, "circuit");
+}
+
+Loopring::Circuit *createCircuit(unsigned int blockType, unsigned int blockSize, ethsnarks::ProtoboardT &outPb)
+{
+    std::cout << "Creating circuit... " << std::endl;
+    auto begin = now();
+    Loopring::Circuit *circuit = newCircuit(blockType, outPb);
+    circuit->generateConstraints(blockSize);
+    circuit->printInfo();
+#ifdef OPTIMIZE_R1CS
+    circuit->optimizeConstraintSystem();
+#endif
+    print_time(begin, "Circuit created");
+    return circuit;
+}
+
+// Builds the circuit and writes its constraints and variables by gadget to `filename`
+bool writeCircuitStats(unsigned int blockType, unsigned int blockSize, const std::string &filename)
+{
+    ethsnarks::ProtoboardT pb;
+    Loopring::ConstraintProfiler profiler(pb);
+    std::unique_ptr<Loopring::Circuit> circuit(createCircuit(blockType, blockSize, pb));
+    Loopring::CircuitStats stats = profiler.getStats();
+    stats.blockType = blockType;
+    stats.blockSize = blockSize;
+
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Cannot create circuit stats file: " << filename << std::endl;
+        return false;
+    }
+    file << json(stats).dump(2);
+    file.close();
+    std::cout << "Circuit stats written to: " << filename << std::endl;
+    return true;
+}
+
+bool compareCircuitStats(const std::string &beforeFilename, const std::string &afterFilename)
+{
+    json before = loadJSON(beforeFilename);
+    json after = loadJSON(afterFilename);
+    if (before == json() || after == json())
+    {
+        return false;
+    }
+    std::cout << Loopring::diffCircuitStats(before.get<Loopring::CircuitStats>(), after.get<Loopring::CircuitStats>());
+    return true;
+}
+
+// Constraint system cache of the key generation modes (-createkeys, -exportcircuit)
+std::string getKeygenConstraintSystemFilename(const std::string &baseFilename)
+{
+    return baseFilename + "_keygen_r1cs.bin";
+}
+
+bool loadConstraintSystem(
+  const std::string &filename,
+  unsigned int blockType,
+  unsigned int blockSize,
+  ethsnarks::ProtoboardT &pb)
+{
+    if (!fileExists(filename))
+    {
+        return false;
+    }
+    std::cout << "Loading constraint system " << filename << "..." << std::endl;
+    auto begin = now();
+    if (!Loopring::readConstraintSystem(filename, blockType, blockSize, pb))
+    {
+        return false;
+    }
+    std::cout << "Num constraints: " << pb.num_constraints() << std::endl;
+    print_time(begin, "Constraint system loaded");
+    return true;
+}
+
+void shrinkCircuit(ethsnarks::ProtoboardT &pb, const libsnark::Config &config)
+{
+    if (config.swapAB)
+    {
+        // pb.constraint_system.swap_AB_if_beneficial();
+    }
+    pb.constraint_system.constraints.shrink_to_fit();
+    pb.values.shrink_to_fit();
+    libsnark::ConstantStorage<FieldT>::getInstance().constants.shrink_to_fit();
+}
+
+bool generateWitness(Loopring::Circuit *circuit, const BlockInput &input)
+{
+    std::cout << "Generating witness... " << std::endl;
+    auto begin = now();
+    if (!(input.parsed ? circuit->generateWitness(input.block) : circuit->generateWitness(input.jBlock)))
+    {
+        std::cerr << "Could not generate witness!" << std::endl;
+        return false;
+    }
+    circuit->assignOptimizedWitness();
+    print_time(begin, "Witness generated");
+    return true;
+}
+
+bool validateCircuit(Loopring::Circuit *circuit)
+{
+    std::cout << "Validating block..." << std::endl;
+    auto begin = now();
+    // Check if the inputs are valid for the circuit
+    #ifndef NDEBUG
+        circuit->printInfo();
+    #endif
+    ethsnarks::ProtoboardT &pb = circuit->getPb();
+    size_t index = Loopring::ConstraintChecker::findFirstUnsatisfied(pb);
+    if (index < pb.num_constraints())
+    {
+        std::cerr << "Block is not valid!" << std::endl;
+        std::cerr << "First unsatisfied constraint: " << index << " in " << circuit->describeConstraint(index) << ": "
+                  << Loopring::ConstraintChecker::getAnnotation(pb, index) << std::endl;
+        return false;
+    }
+    ethsnarks::ProtoboardT &provingPb = circuit->getProvingPb();
+    if (&provingPb != &pb &&
+        Loopring::ConstraintChecker::findFirstUnsatisfied(provingPb) < provingPb.num_constraints())
+    {
+        std::cerr << "Witness of the optimized constraint system is not valid!" << std::endl;
+        return false;
+    }
+    print_time(begin, "Block is valid");
+    return true;
+}
+
+std::string getBaseName(unsigned int blockType)
+{
+    return Loopring::getBlockTypeName(blockType);
+}
+
+// Prefers the proving key in the bulk format (see -pk_raw2bulk) when available
+std::string getProvingKeyFilename(const std::string &baseFilename)
+{
+    std::string bulkFilename = baseFilename + "_pk.bulk";
+    if (fileExists(bulkFilename))
+    {
+        return bulkFilename;
+    }
+    return baseFilename + "_pk.raw";
+}
+
+std::string getVerificationKeyFilename(const std::string &provingKeyFilename)
+{
+    return provingKeyFilename.substr(0, provingKeyFilename.rfind("_pk.")) + "_vk.json";
+}
+
+// The block sizes of the block type with a proving key (<name>_<blockSize>_pk.raw or .bulk) in the keys folder
+std::vector<unsigned int> getAvailableBlockSizes(const std::string &keysFolder, unsigned int blockType)
+{
+    std::vector<unsigned int> blockSizes;
+    DIR *dir = opendir(keysFolder.c_str());
+    if (dir == nullptr)
+    {
+        return blockSizes;
+    }
+    const std::string prefix = getBaseName(blockType) + "_";
+    while (struct dirent *entry = readdir(dir))
+    {
+        const std::string name = entry->d_name;
+        const size_t end = name.rfind("_pk.");
+        if (name.compare(0, prefix.size(), prefix) != 0 || end == std::string::npos || end <= prefix.size())
+        {
+            continue;
+        }
+        const std::string size = name.substr(prefix.size(), end - prefix.size());
+        const std::string extension = name.substr(end);
+        if (size.find_first_not_of("0123456789") != std::string::npos ||
+            (extension != "_pk.raw" && extension != "_pk.bulk"))
+        {
+            continue;
+        }
+        const unsigned int blockSize = std::stoi(size);
+        if (std::find(blockSizes.begin(), blockSizes.end(), blockSize) == blockSizes.end())
+        {
+            blockSizes.push_back(blockSize);
+        }
+    }
+    closedir(dir);
+    std::sort(blockSizes.begin(), blockSizes.end());
+    return blockSizes;
+}
+
+// The smallest of `blockSizes` a block without a block size fits in after padding, 0 if there is none.
+// On failure `error` contains the error message.
+unsigned int selectPaddedBlockSize(BlockInput &input, const std::vector<unsigned int> &blockSizes, std::string &error)
+{
+    if (!input.parsed)
+    {
+        input.block = input.jBlock.get<Loopring::Block>();
+        input.parsed = true;
+    }
+    const unsigned int blockSize = Loopring::selectBlockSize(input.block, input.blockType, blockSizes);
+    if (blockSize == 0)
+    {
+        error = "Error: No block size available for " + std::to_string(input.block.transactions.size()) +
+                " transactions!\n";
+        if (!Loopring::canPadBlock(input.block))
+        {
+            error += "Blocks without a block size are padded with copies of the noop before the withdrawals, "
+                     "the block has none.\n";
+        }
+    }
+    return blockSize;
+}
+
+// Pads a block without a block size to the smallest of `blockSizes` it fits in.
+// The block has to be signed for the padded block size (see BlockPadding.h), -selectsize
+// returns the block size that will be used. On failure `error` contains the error message.
+bool padBlockInput(BlockInput &input, const std::vector<unsigned int> &blockSizes, std::string &error)
+{
+    if (input.blockSize != 0)
+    {
+        return true;
+    }
+    const unsigned int blockSize = selectPaddedBlockSize(input, blockSizes, error);
+    if (blockSize == 0)
+    {
+        return false;
+    }
+    std::cout << "Padding " << input.block.transactions.size() << " transactions to block size " << blockSize
+              << std::endl;
+    Loopring::padBlock(input.block, blockSize);
+    input.blockSize = blockSize;
+    return true;
+}
+
+bool pk_raw2bulk(const std::string &pkFilename, const std::string &bulkFilename)
+{
+    ethsnarks::ProvingKeyT pk;
+    loadProvingKey(pkFilename, pk);
+    return Loopring::writeBulkProvingKey(pk, bulkFilename);
+}
+
+// The proof of a finished job, with the result of the self-verification once known
+static json proofToJson(const ProverJob &job)
+{
+    json proof = json::parse(job.result);
+    if (job.proofCheck == ProofCheck::Verified || job.proofCheck == ProofCheck::Invalid)
+    {
+        proof["verified"] = (job.proofCheck == ProofCheck::Verified);
+    }
+    return proof;
+}
+
+static json jobToJson(const ProverJob &job)
+{
+    json j;
+    j["id"] = job.id;
+    j["status"] = jobStatusToString(job.status);
+    j["block_filename"] = job.blockFilename;
+    j["proof_filename"] = job.proofFilename;
+    j["verification"] = proofCheckToString(job.proofCheck);
+    if (job.blockSize != 0)
+    {
+        j["block_size"] = job.blockSize;
+    }
+    if (job.padded)
+    {
+        j["padding"] = "The block is padded with noops to block_size transactions, "
+                       "it has to be signed for block_size";
+    }
+    if (job.status == JobStatus::Done)
+    {
+        j["proof"] = proofToJson(job);
+    }
+    else if (job.status == JobStatus::Failed)
+    {
+        j["error"] = job.result;
+    }
+    return j;
+}
+
+// Metrics exposed by the prover server on /metrics
+struct ServerMetrics
+{
+    Loopring::MetricsRegistry registry;
+
+    Loopring::Counter &jobsSubmitted;
+    Loopring::Counter &jobsRejected;
+    Loopring::Counter &jobsDone;
+    Loopring::Counter &jobsFailed;
+    Loopring::Counter &jobsVerifyFailed;
+    Loopring::Counter &invalidProofs;
+
+    Loopring::Histogram &queueWait;
+    Loopring::Histogram &blockLoad;
+    Loopring::Histogram &precheck;
+    Loopring::Histogram &witness;
+    Loopring::Histogram &validation;
+    Loopring::Histogram &proving;
+    Loopring::Histogram &verification;
+    Loopring::Histogram &proofSize;
+
+    ServerMetrics()
+        : jobsSubmitted(registry.counter("prover_jobs_submitted_total", "Jobs accepted in the queue")),
+          jobsRejected(registry.counter("prover_jobs_rejected_total", "Jobs rejected because the queue was full")),
+          jobsDone(registry.counter("prover_jobs_finished_total", "Finished jobs", "result=\"done\"")),
+          jobsFailed(registry.counter("prover_jobs_finished_total", "Finished jobs", "result=\"failed\"")),
+          jobsVerifyFailed(registry.counter("prover_jobs_finished_total", "Finished jobs", "result=\"verify_failed\"")),
+          invalidProofs(registry.counter("prover_proofs_invalid_total", "Proofs that failed the self-verification")),
+          queueWait(registry.histogram("prover_queue_wait_seconds", "Time jobs wait in the queue", secondsBuckets())),
+          blockLoad(registry.histogram("prover_block_load_seconds", "Time to load a block", secondsBuckets())),
+          precheck(registry.histogram("prover_precheck_seconds", "Time to precheck a block", secondsBuckets())),
+          witness(registry.histogram("prover_witness_seconds", "Time to generate the witness", secondsBuckets())),
+          validation(registry.histogram("prover_validation_seconds", "Time to validate the witness", secondsBuckets())),
+          proving(registry.histogram("prover_proving_seconds", "Time to generate the proof", secondsBuckets())),
+          verification(registry.histogram("prover_verification_seconds", "Time to verify the proof", secondsBuckets())),
+          proofSize(registry.histogram("prover_proof_size_bytes", "Size of the proof json", {512, 1024, 2048, 4096}))
+    {
+    }
+
+    static std::vector<double> secondsBuckets()
+    {
+        return {0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500};
+    }
+};
+
+// Loads the block of a job. On failure `result` contains the error message.
+bool loadJob(const ProverJob &job, BlockInput &input, std::string &result, ServerMetrics &metrics)
+{
+    try
+    {
+        auto begin = now();
+        if (!loadBlockInput(job.blockFilename, input))
+        {
+            result = "Error: Failed to load block!\n";
+            return false;
+        }
+        metrics.blockLoad.observe(elapsed_time_s(begin));
+        return true;
+    }
+    catch (std::exception &e)
+    {
+        result = std::string("Prove error, exception:") + std::string(e.what());
+        std::cout << result << std::endl;
+        return false;
+    }
+}
+
+// Rejects a block that fails the precheck. On failure `result` contains the error message.
+bool precheckJob(const BlockInput &input, std::string &result, ServerMetrics &metrics)
+{
+    try
+    {
+        auto begin = now();
+        Loopring::PrecheckResult precheck = precheckBlock(input);
+        metrics.precheck.observe(elapsed_time_s(begin));
+        if (!precheck.valid)
+        {
+            result = "Error: Block failed the precheck: " + precheckResultToString(precheck) + "\n";
+            return false;
+        }
+        return true;
+    }
+    catch (std::exception &e)
+    {
+        result = std::string("Precheck error, exception:") + std::string(e.what());
+        std::cout << result << std::endl;
+        return false;
+    }
+}
+
+// First stage of a job: generates (and optionally validates) the witness.
+// On failure `result` contains the error message.
+bool prepareJob(
+  Loopring::Circuit *circuit,
+  const BlockInput &input,
+  const ProverJob &job,
+  std::string &result,
+  ServerMetrics &metrics)
+{
+    try
+    {
+        auto begin = now();
+        if (!generateWitness(circuit, input))
+        {
+            result = "Error: Failed to generate witness for block!\n";
+            return false;
+        }
+        metrics.witness.observe(elapsed_time_s(begin));
+        if (job.validate)
+        {
+            begin = now();
+            if (!validateCircuit(circuit))
+            {
+                result = "Error: Block is invalid!\n";
+                return false;
+            }
+            metrics.validation.observe(elapsed_time_s(begin));
+        }
+        return true;
+    }
+    catch (std::exception &e)
+    {
+        result = std::string("Prove error, exception:") + std::string(e.what());
+        std::cout << result << std::endl;
+        return false;
+    }
+}
+
+// Second stage of a job: proves the witness stored in the circuit.
+// On success `result` contains the proof json, otherwise the error message.
+bool proveJob(
+  ProverContextT &context,
+  Loopring::Circuit *circuit,
+  const ProverJob &job,
+  std::string &result,
+  ServerMetrics &metrics)
+{
+    try
+    {
+        auto begin = now();
+        std::string jProof = proveCircuit(context, circuit);
+        if (jProof.length() == 0)
+        {
+            result = "Error: Failed to prove block!\n";
+            return false;
+        }
+        metrics.proving.observe(elapsed_time_s(begin));
+        metrics.proofSize.observe(jProof.length());
+        if (job.proofFilename.length() != 0)
+        {
+            if (!writeProof(jProof, job.proofFilename))
+            {
+                result = "Error: Failed to write proof!\n";
+                return false;
+            }
+        }
+        result = jProof;
+
+        if (job.delFile)
+        {
+            std::remove(job.blockFilename.c_str());
+        }
+        return true;
+    }
+    catch (std::exception &e)
+    {
+        result = std::string("Prove error, exception:") + std::string(e.what());
+        std::cout << result << std::endl;
+        return false;
+    }
+}
+
+// Verifies a proof generated by proveJob
+bool verifyJob(const VerificationKeyT &vk, const std::string &jProof, ServerMetrics &metrics)
+{
+    try
+    {
+        auto begin = now();
+        std::stringstream proof_stream;
+        proof_stream << jProof;
+        auto proof_pair = proof_from_json(proof_stream);
+        bool verified =
+          libsnark::r1cs_gg_ppzksnark_zok_verifier_strong_IC<ppT>(vk, proof_pair.first, proof_pair.second);
+        std::cout << "verified:" << verified << std::endl;
+        metrics.verification.observe(elapsed_time_s(begin));
+        if (!verified)
+        {
+            metrics.invalidProofs.inc();
+        }
+        return verified;
+    }
+    catch (std::exception &e)
+    {
+        std::cout << "Verify error, exception:" << e.what() << std::endl;
+        metrics.invalidProofs.inc();
+        return false;
+    }
+}
+
+static bool parseJobRequest(const httplib::Request &req, ProverJob &job, std::string &error)
+{
+    job.blockFilename = req.get_param_value("block_filename");
+    job.proofFilename = req.get_param_value("proof_filename");
+    job.validate = (req.get_param_value("validate").compare("true") == 0) ? true : false;
+    job.delFile = (req.get_param_value("delFile").compare("true") == 0) ? true : false;
+    if (job.blockFilename.length() == 0)
+    {
+        error = "Error: block_filename missing!\n";
+        return false;
+    }
+    return true;
+}
+
+// Everything needed to prove blocks of a single block size. With more than one
+// circuit the witness of the next block is generated while the current block is
+// being proven.
+struct ProverInstance
+{
+    unsigned int blockType = 0;
+    unsigned int blockSize = 0;
+    std::string provingKeyFilename;
+    // Loaded once, shared with the verifier thread (which can outlive the instance)
+    std::shared_ptr<const VerificationKeyT> vk;
+
+    std::vector<std::unique_ptr<ethsnarks::ProtoboardT>> pbs;
+    std::vector<Loopring::Circuit *> circuits;
+    // The constraint system is the same for all circuits
+    ProverContextT context;
+    // Circuits not used by any job
+    Channel<unsigned int> freeCircuits;
+
+    // Memory used by the instance (RSS growth while loading)
+    unsigned int memoryMB = 0;
+    // Number of jobs currently using a circuit of this instance
+    unsigned int numActive = 0;
+    std::chrono::steady_clock::time_point lastUsed;
+
+    ~ProverInstance()
+    {
+        for (Loopring::Circuit *circuit : circuits)
+        {
+            delete circuit;
+        }
+    }
+};
+
+// The block sizes a server can prove. Sizes are loaded on demand when a block
+// of that size is submitted and idle sizes are unloaded (least recently used
+// first) to stay under the memory budget.
+class ProverRegistry
+{
+  public:
+    // Every block type has its own circuits and keys
+    typedef std::pair<unsigned int, unsigned int> InstanceKey; // (blockType, blockSize)
+
+    // Held while proving and while creating circuits. Creating a circuit adds to
+    // the shared libsnark::ConstantStorage, which the prover reads from.
+    std::mutex proverMutex;
+
+    ProverRegistry(
+      const std::string &_keysFolder,
+      const libsnark::Config &_config,
+      unsigned int _numCircuits,
+      unsigned int _memoryBudgetMB)
+        : keysFolder(_keysFolder), config(_config), numCircuits(_numCircuits), memoryBudgetMB(_memoryBudgetMB)
+    {
+    }
+
+    // Returns the instance for the block size, loading it if necessary.
+    // Loading is only done from a single thread (the witness worker).
+    ProverInstance *acquire(unsigned int blockType, unsigned int blockSize, std::string &error)
+    {
+        if (blockType >= (unsigned int)Loopring::BlockType::COUNT)
+        {
+            error = "Error: Invalid block type: " + std::to_string(blockType) + "\n";
+            return nullptr;
+        }
+        blockType = Loopring::getCircuitBlockType(blockType);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = instances.find(InstanceKey(blockType, blockSize));
+            if (it != instances.end())
+            {
+                it->second->numActive++;
+                it->second->lastUsed = std::chrono::steady_clock::now();
+                return it->second.get();
+            }
+        }
+
+        std::string provingKeyFilename =
+          getProvingKeyFilename(keysFolder + getBaseName(blockType) + "_" + std::to_string(blockSize));
+        if (!fileExists(provingKeyFilename))
+        {
+            error = "Error: Incompatible block requested! Use /info to check "
+                    "which blocks can be proven.\n";
+            return nullptr;
+        }
+
+        makeRoom(InstanceKey(blockType, blockSize));
+        std::unique_ptr<ProverInstance> instance;
+        try
+        {
+            instance = load(blockType, blockSize, provingKeyFilename);
+        }
+        catch (std::exception &e)
+        {
+            error = std::string("Error: Failed to load block size, exception:") + std::string(e.what());
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        knownMemoryMB[InstanceKey(blockType, blockSize)] = instance->memoryMB;
+        instance->numActive++;
+        instance->lastUsed = std::chrono::steady_clock::now();
+        ProverInstance *result = instance.get();
+        instances[InstanceKey(blockType, blockSize)] = std::move(instance);
+        return result;
+    }
+
+    void release(ProverInstance *instance)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        instance->numActive--;
+    }
+
+    json info()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        json j = json::array();
+        for (const auto &pair : instances)
+        {
+            json jInstance;
+            jInstance["blockType"] = pair.second->blockType;
+            jInstance["blockSize"] = pair.second->blockSize;
+            jInstance["numCircuits"] = pair.second->circuits.size();
+            jInstance["memoryMB"] = pair.second->memoryMB;
+            jInstance["numActive"] = pair.second->numActive;
+            j.push_back(jInstance);
+        }
+        return j;
+    }
+
+    unsigned int getMemoryBudgetMB() const
+    {
+        return memoryBudgetMB;
+    }
+
+    // The block sizes with keys, blocks without a block size are padded to one of these
+    std::vector<unsigned int> getBlockSizes(unsigned int blockType) const
+    {
+        return getAvailableBlockSizes(keysFolder, blockType);
+    }
+
+  private:
+    std::unique_ptr<ProverInstance> load(
+      unsigned int blockType,
+      unsigned int blockSize,
+      const std::string &provingKeyFilename)
+    {
+        std::cout << "Loading block size " << blockSize << "..." << std::endl;
+        auto begin = now();
+        unsigned int memoryBefore = getResidentMemoryMB();
+
+        std::unique_ptr<ProverInstance> instance(new ProverInstance());
+        instance->blockType = blockType;
+        instance->blockSize = blockSize;
+        instance->provingKeyFilename = provingKeyFilename;
+        instance->vk = std::make_shared<const VerificationKeyT>(
+          loadVerificationKey(getVerificationKeyFilename(provingKeyFilename)));
+        {
+            std::lock_guard<std::mutex> lock(proverMutex);
+            for (unsigned int i = 0; i < numCircuits; i++)
+            {
+                instance->pbs.emplace_back(new ethsnarks::ProtoboardT());
+                instance->circuits.push_back(createCircuit(blockType, blockSize, *instance->pbs.back()));
+                shrinkCircuit(*instance->pbs.back(), config);
+                instance->freeCircuits.push(i);
+            }
+        }
+
+        ProverContextT &context = instance->context;
+        loadProvingKey(provingKeyFilename, context.provingKey);
+        context.constraint_system = &(instance->circuits[0]->getProvingPb().constraint_system);
+        context.config = config;
+        context.domain = get_domain(instance->circuits[0]->getProvingPb(), context.provingKey, config);
+        initProverContextBuffers(context);
+
+        unsigned int memoryAfter = getResidentMemoryMB();
+        instance->memoryMB = (memoryAfter > memoryBefore) ? memoryAfter - memoryBefore : 0;
+        print_time(begin, (std::string("Block size ") + std::to_string(blockSize) + " loaded").c_str());
+        printMemoryUsage();
+        return instance;
+    }
+
+    // Unloads idle instances until the new block size fits in the memory budget
+    void makeRoom(const InstanceKey &key)
+    {
+        if (memoryBudgetMB == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        unsigned int required = knownMemoryMB.count(key) ? knownMemoryMB[key] : 0;
+        while (true)
+        {
+            unsigned int used = 0;
+            auto lru = instances.end();
+            for (auto it = instances.begin(); it != instances.end(); ++it)
+            {
+                used += it->second->memoryMB;
+                if (it->second->numActive == 0 && (lru == instances.end() || it->second->lastUsed < lru->second->lastUsed))
+                {
+                    lru = it;
+                }
+            }
+            if (used + required <= memoryBudgetMB || lru == instances.end())
+            {
+                if (used + required > memoryBudgetMB)
+                {
+                    std::cout << "Memory budget exceeded, all block sizes are in use" << std::endl;
+                }
+                break;
+            }
+            std::cout << "Unloading block size " << lru->first.second << " (" << getBaseName(lru->first.first) << ")"
+                      << std::endl;
+            instances.erase(lru);
+            trimMemory();
+        }
+    }
 
-Loopring::Circuit *newCircuit(unsigned int blockType, ethsnarks::ProtoboardT &outPb)
-{
-    return new Loopring::UniversalCircuit(outPb, "circuit");
-}
+    const std::string keysFolder;
+    const libsnark::Config config;
+    const unsigned int numCircuits;
+    const unsigned int memoryBudgetMB;
 
-Loopring::Circuit *createCircuit(unsigned int blockType, unsigned int blockSize, ethsnarks::ProtoboardT &outPb)
-{
-    std::cout << "Creating circuit... " << std::endl;
-    auto begin = now();
-    Loopring::Circuit *circuit = newCircuit(blockType, outPb);
-    circuit->generateConstraints(blockSize);
-    circuit->printInfo();
-    print_time(begin, "Circuit created");
-    return circuit;
-}
+    std::map<InstanceKey, std::unique_ptr<ProverInstance>> instances;
+    // Memory used by the block sizes loaded before (for the budget)
+    std::map<InstanceKey, unsigned int> knownMemoryMB;
+    std::mutex mtx;
+};
 
-bool generateWitness(Loopring::Circuit *circuit, const json &input)
+// A job whose witness is ready to be proven in instance->circuits[circuitIdx]
+struct PreparedJob
 {
-    std::cout << "Generating witness... " << std::endl;
-    auto begin = now();
-    if (!circuit->generateWitness(input))
-    {
-        std::cerr << "Could not generate witness!" << std::endl;
-        return false;
-    }
-    print_time(begin, "Witness generated");
-    return true;
-}
+    ProverJob job;
+    ProverInstance *instance;
+    unsigned int circuitIdx;
+};
 
-bool validateCircuit(Loopring::Circuit *circuit)
+// Blocks without a block size are padded when they are proven (see padBlockInput). These are
+// checked on submission, so a block that can't be padded is rejected right away instead of
+// failing in the queue. Sets the block size the block will be padded to.
+bool checkBlockPadding(ProverJob &job, const ProverRegistry &registry, std::string &error)
 {
-    std::cout << "Validating block..." << std::endl;
-    auto begin = now();
-    // Check if the inputs are valid for the circuit
-    #ifndef NDEBUG
-        circuit->printInfo();
-    #endif
-    if (!circuit->getPb().is_satisfied())
+    try
     {
-        std::cerr << "Block is not valid!" << std::endl;
-        return false;
+        BlockInput input;
+        if (!loadBlockInput(job.blockFilename, input))
+        {
+            error = "Error: Failed to load block!\n";
+            return false;
+        }
+        if (input.blockSize != 0)
+        {
+            return true;
+        }
+        job.blockSize = selectPaddedBlockSize(input, registry.getBlockSizes(input.blockType), error);
+        job.padded = true;
+        return job.blockSize != 0;
     }
-    print_time(begin, "Block is valid");
-    return true;
-}
-
-std::string getBaseName(unsigned int blockType)
-{
-    switch (blockType)
+    catch (std::exception &e)
     {
-        default:
-            return "all";
+        error = std::string("Error: Invalid block: ") + e.what() + "\n";
+        return false;
     }
 }
 
-std::string getProvingKeyFilename(const std::string &baseFilename)
+// A proof waiting to be verified off the critical path
+struct VerifyTask
 {
-    return baseFilename + "_pk.raw";
-}
+    unsigned int jobID;
+    std::shared_ptr<const VerificationKeyT> vk;
+    std::string proof;
+};
 
 void runServer(
-  ProverContextT &context,
-  Loopring::Circuit *circuit,
-  const std::string &provingKeyFilename,
-  const libsnark::Config &config,
-  unsigned int port)
+  ProverRegistry &registry,
+  unsigned int port,
+  unsigned int queueSize,
+  VerifyMode verifyMode,
+  bool precheck)
 {
     using namespace httplib;
 
-    struct ProverStatus
-    {
-        bool proving = false;
-        std::string blockFilename;
-        std::string proofFilename;
+    // Blocks waiting to be proven
+    JobQueue jobQueue(queueSize);
+
+    ServerMetrics metrics;
+    metrics.registry.gauge("prover_queue_length", "Jobs waiting in the queue", [&]() {
+        return double(jobQueue.numPending());
+    });
+    metrics.registry.gauge("prover_block_sizes_loaded", "Number of block sizes loaded", [&]() {
+        return double(registry.info().size());
+    });
+    metrics.registry.gauge("prover_resident_memory_bytes", "Resident memory of the process", []() {
+        return double(getResidentMemoryMB()) * 1024 * 1024;
+    });
+    metrics.registry.gauge("prover_threads", "Number of threads of the process", []() {
+        return double(getNumThreads());
+    });
+#ifdef MULTICORE
+    metrics.registry.gauge("prover_omp_max_threads", "Number of OpenMP threads used for proving", []() {
+        return double(omp_get_max_threads());
+    });
+#endif
+    // Jobs are counted once their proof check is known, see countProofCheck
+    auto countProofCheck = [&](ProofCheck proofCheck) {
+        (proofCheck == ProofCheck::Invalid ? metrics.jobsVerifyFailed : metrics.jobsDone).inc();
+    };
+    auto finishJob = [&](unsigned int id, bool success, const std::string &result, ProofCheck proofCheck) {
+        if (!success)
+        {
+            metrics.jobsFailed.inc();
+        }
+        else if (proofCheck != ProofCheck::Pending)
+        {
+            countProofCheck(proofCheck);
+        }
+        jobQueue.finish(id, success, result, proofCheck);
     };
 
-    struct ProverStatusRAII
-    {
-        ProverStatus &proverStatus;
-        ProverStatusRAII(
-          ProverStatus &_proverStatus,
-          const std::string &blockFilename,
-          const std::string &proofFilename)
-            : proverStatus(_proverStatus)
+    // Circuits with a witness ready to be proven
+    Channel<PreparedJob> preparedJobs;
+
+    // Witness worker: routes the block to the circuit for its block size and fills in the witness
+    std::thread witnessWorker([&]() {
+        ProverJob job;
+        while (jobQueue.pop(job))
         {
-            proverStatus.proving = true;
-            proverStatus.blockFilename = blockFilename;
-            proverStatus.proofFilename = proofFilename;
+            metrics.queueWait.observe(std::chrono::duration<double>(job.started - job.submitted).count());
+            std::string result;
+            BlockInput input;
+            if (!loadJob(job, input, result, metrics) || (precheck && !precheckJob(input, result, metrics)) ||
+                !padBlockInput(input, registry.getBlockSizes(input.blockType), result))
+            {
+                finishJob(job.id, false, result, ProofCheck::None);
+                continue;
+            }
+            jobQueue.setBlockSize(job.id, input.blockSize);
+            ProverInstance *instance = registry.acquire(input.blockType, input.blockSize, result);
+            if (instance == nullptr)
+            {
+                finishJob(job.id, false, result, ProofCheck::None);
+                continue;
+            }
+            unsigned int circuitIdx;
+            instance->freeCircuits.pop(circuitIdx);
+            if (!prepareJob(instance->circuits[circuitIdx], input, job, result, metrics))
+            {
+                finishJob(job.id, false, result, ProofCheck::None);
+                instance->freeCircuits.push(circuitIdx);
+                registry.release(instance);
+                continue;
+            }
+            preparedJobs.push({job, instance, circuitIdx});
         }
+        preparedJobs.close();
+    });
+
+    // Proofs to verify in VerifyMode::Async
+    Channel<VerifyTask> verifyTasks;
 
-        ~ProverStatusRAII()
+    // Prover worker, the only thread using the prover contexts
+    std::thread proverWorker([&]() {
+        PreparedJob prepared;
+        while (preparedJobs.pop(prepared))
         {
-            proverStatus.proving = false;
+            ProverInstance *instance = prepared.instance;
+            jobQueue.setStatus(prepared.job.id, JobStatus::Proving);
+            std::string result;
+            bool success;
+            {
+                std::lock_guard<std::mutex> lock(registry.proverMutex);
+                success = proveJob(
+                  instance->context, instance->circuits[prepared.circuitIdx], prepared.job, result, metrics);
+            }
+            instance->freeCircuits.push(prepared.circuitIdx);
+            if (!success)
+            {
+                finishJob(prepared.job.id, false, result, ProofCheck::None);
+            }
+            else if (verifyMode == VerifyMode::Sync)
+            {
+                bool verified = verifyJob(*instance->vk, result, metrics);
+                finishJob(prepared.job.id, true, result, verified ? ProofCheck::Verified : ProofCheck::Invalid);
+            }
+            else if (verifyMode == VerifyMode::Async)
+            {
+                finishJob(prepared.job.id, true, result, ProofCheck::Pending);
+                verifyTasks.push({prepared.job.id, instance->vk, result});
+            }
+            else
+            {
+                finishJob(prepared.job.id, true, result, ProofCheck::None);
+            }
+            registry.release(instance);
         }
-    };
+        verifyTasks.close();
+    });
+
+    // Verifier worker, reports the result next to the (final) job status
+    std::thread verifierWorker([&]() {
+        VerifyTask task;
+        while (verifyTasks.pop(task))
+        {
+            bool verified = verifyJob(*task.vk, task.proof, metrics);
+            countProofCheck(verified ? ProofCheck::Verified : ProofCheck::Invalid);
+            jobQueue.setProofCheck(task.jobID, verified);
+        }
+    });
 
-    // Prover status info
-    ProverStatus proverStatus;
-    // Lock for the prover
-    std::mutex mtx;
     // Setup the server
     Server svr;
-    // Called to prove blocks
-    svr.Get("/prove", [&](const Request &req, Response &res) {
-    		try
-    		{
-			const std::lock_guard<std::mutex> lock(mtx);
-
-			// Parse the parameters
-			std::string blockFilename = req.get_param_value("block_filename");
-			std::string proofFilename = req.get_param_value("proof_filename");
-			std::string strValidate = req.get_param_value("validate");
-			bool validate = (strValidate.compare("true") == 0) ? true : false;
-			if (blockFilename.length() == 0)
-			{
-				res.set_content("Error: block_filename missing!\n", "text/plain");
-				return;
-			}
-			std::string strDelFile = req.get_param_value("delFile");
-			bool delFileAfterSuccess = (strDelFile.compare("true") == 0) ? true : false;
-
-			// Set the prover status for this session
-			ProverStatusRAII statusRAII(proverStatus, blockFilename, proofFilename);
-
-			// Prove the block
-			json input = loadJSON(blockFilename);
-			if (input == json())
-			{
-				res.set_content("Error: Failed to load block!\n", "text/plain");
-				return;
-			}
-
-			// Check if this block is compatible with the loaded circuit
-			int iBlockType = input["blockType"].get<int>();
-			unsigned int blockSize = input["blockSize"].get<int>();
-			if (/*iBlockType & circuit->getBlockType() != 1 || */ blockSize != circuit->getBlockSize())
-			{
-				res.set_content(
-				  "Error: Incompatible block requested! Use /info to check "
-				  "which blocks can be proven.\n",
-				  "text/plain");
-				return;
-			}
-
-			if (!generateWitness(circuit, input))
-			{
-				res.set_content("Error: Failed to generate witness for block!\n", "text/plain");
-				return;
-			}
-			if (validate)
-			{
-				if (!validateCircuit(circuit))
-				{
-					res.set_content("Error: Block is invalid!\n", "text/plain");
-					return;
-				}
-			}
-			std::string jProof = proveCircuit(context, circuit);
-			if (jProof.length() == 0)
-			{
-				res.set_content("Error: Failed to prove block!\n", "text/plain");
-				return;
-			}
-			if (proofFilename.length() != 0)
-			{
-				if (!writeProof(jProof, proofFilename))
-				{
-					res.set_content("Error: Failed to write proof!\n", "text/plain");
-					return;
-				}
-			}
-
-			// verify the proof.
-			VerificationKeyT vk = loadVerificationKey(provingKeyFilename.substr(0, provingKeyFilename.length() - 6) + "vk.json");
-            std::stringstream proof_stream;
-            proof_stream << jProof;
-            auto proof_pair = proof_from_json(proof_stream);
-
-            std::cout << "proof:" << jProof;
-            bool verified = libsnark::r1cs_gg_ppzksnark_zok_verifier_strong_IC<ppT>(vk, proof_pair.first, proof_pair.second);
-            std::cout << "verified:" << verified << std::endl;
-            json proofJson = json::parse(jProof);
-            proofJson["verified"] = verified;
-
-			// Return the proof
-			res.set_content(proofJson.dump() + "\n", "text/plain");
-			if(delFileAfterSuccess){
-					std::remove(blockFilename.c_str());
-			}
-    		}catch(std::exception& e)
-    		{
-    			std::string message = std::string("Prove error, exception:") + std::string(e.what());
-    			std::cout << message << std::endl;
-    			res.set_content(message, "text/plain");
-    			return;
-    		}
+    // Queues a block and returns immediately with the job id
+    svr.Get("/submit", [&](const Request &req, Response &res) {
+        ProverJob job;
+        std::string error;
+        if (!parseJobRequest(req, job, error))
+        {
+            res.set_content(error, "text/plain");
+            return;
+        }
+        if (!checkBlockPadding(job, registry, error))
+        {
+            res.status = 400;
+            res.set_content(error, "text/plain");
+            return;
+        }
+        if (!jobQueue.submit(job))
+        {
+            metrics.jobsRejected.inc();
+            res.status = 503;
+            res.set_content("Error: Prover queue is full!\n", "text/plain");
+            return;
+        }
+        metrics.jobsSubmitted.inc();
+        res.set_content(jobToJson(job).dump() + "\n", "application/json");
     });
-    // Retun the status of the server
-    svr.Get("/status", [&](const Request &req, Response &res) {
-        if (proverStatus.proving)
+    // Status (and proof when done) of a single job
+    svr.Get("/job", [&](const Request &req, Response &res) {
+        ProverJob job;
+        std::string strID = req.get_param_value("id");
+        if (!jobQueue.get(std::strtoul(strID.c_str(), nullptr, 10), job))
+        {
+            res.status = 404;
+            res.set_content("Error: Unknown job!\n", "text/plain");
+            return;
+        }
+        res.set_content(jobToJson(job).dump() + "\n", "application/json");
+    });
+    // All queued, running and recently finished jobs
+    svr.Get("/jobs", [&](const Request &req, Response &res) {
+        json jobs = json::array();
+        for (const ProverJob &job : jobQueue.list())
+        {
+            json j = jobToJson(job);
+            j.erase("proof");
+            jobs.push_back(j);
+        }
+        res.set_content(jobs.dump() + "\n", "application/json");
+    });
+    // Called to prove blocks, waits until the proof is available
+    svr.Get("/prove", [&](const Request &req, Response &res) {
+        ProverJob job;
+        std::string error;
+        if (!parseJobRequest(req, job, error))
+        {
+            res.set_content(error, "text/plain");
+            return;
+        }
+        if (!checkBlockPadding(job, registry, error))
+        {
+            res.status = 400;
+            res.set_content(error, "text/plain");
+            return;
+        }
+        if (!jobQueue.submit(job))
+        {
+            metrics.jobsRejected.inc();
+            res.set_content("Error: Prover queue is full!\n", "text/plain");
+            return;
+        }
+        metrics.jobsSubmitted.inc();
+        if (!jobQueue.wait(job.id, job))
+        {
+            res.set_content("Error: Job was dropped!\n", "text/plain");
+            return;
+        }
+        if (job.status != JobStatus::Done)
+        {
+            res.set_content(job.result, "text/plain");
+        }
+        else if (job.proofCheck == ProofCheck::None)
+        {
+            res.set_content(job.result + "\n", "text/plain");
+        }
+        else if (job.proofCheck == ProofCheck::Pending)
         {
-            std::string status = std::string("Proving ") + proverStatus.blockFilename;
-            res.set_content(status + "\n", "text/plain");
+            // Verified in the background (VerifyMode::Async), poll /job with this id for the result
+            json proof = proofToJson(job);
+            proof["job_id"] = job.id;
+            res.set_content(proof.dump() + "\n", "text/plain");
         }
         else
         {
-            res.set_content("Idle\n", "text/plain");
+            res.set_content(proofToJson(job).dump() + "\n", "text/plain");
+        }
+    });
+    // Retun the status of the server
+    svr.Get("/status", [&](const Request &req, Response &res) {
+        std::string status;
+        for (const ProverJob &job : jobQueue.list())
+        {
+            if (job.status == JobStatus::Witness)
+            {
+                status += std::string("Generating witness ") + job.blockFilename + "; ";
+            }
+            else if (job.status == JobStatus::Proving)
+            {
+                status += std::string("Proving ") + job.blockFilename + "; ";
+            }
         }
+        status = (status.length() == 0) ? "Idle; " : status;
+        status += "Queued: " + std::to_string(jobQueue.numPending()) + "/" + std::to_string(jobQueue.getCapacity());
+        res.set_content(status + "\n", "text/plain");
     });
     // Info of this prover server
     svr.Get("/info", [&](const Request &req, Response &res) {
-        std::string info = std::string("BlockType: ") + std::to_string(int(circuit->getBlockType())) +
-                           std::string("; BlockSize: ") + std::to_string(circuit->getBlockSize()) + "\n";
+        std::string info;
+        for (const json &instance : registry.info())
+        {
+            info += std::string("BlockType: ") + std::to_string(instance["blockType"].get<unsigned int>()) +
+                    std::string("; BlockSize: ") + std::to_string(instance["blockSize"].get<unsigned int>()) +
+                    std::string("; Circuits: ") + std::to_string(instance["numCircuits"].get<unsigned int>()) +
+                    std::string("; Memory: ") + std::to_string(instance["memoryMB"].get<unsigned int>()) + "MB\n";
+        }
+        info += std::string("Memory budget: ") + std::to_string(registry.getMemoryBudgetMB()) +
+                "MB (other block sizes are loaded on demand when their keys are available)\n";
         res.set_content(info, "text/plain");
     });
+    // Metrics in the Prometheus text format
+    svr.Get("/metrics", [&](const Request &req, Response &res) {
+        res.set_content(metrics.registry.render(), "text/plain; version=0.0.4");
+    });
     // Stops the prover server
     svr.Get("/stop", [&](const Request &req, Response &res) {
-        const std::lock_guard<std::mutex> lock(mtx);
+        jobQueue.stop();
         svr.stop();
     });
     // Help info
@@ -531,15 +1567,25 @@ void runServer(
         content += "- Prove a block: "
                    "/prove?block_filename=<block.json>&proof_filename=<proof.json>&"
                    "validate=true (proof_filename and validate are optional)\n";
+        content += "- Queue a block: /submit (same parameters as /prove, returns the job id)\n";
+        content += "- Status of a job: /job?id=<id> (contains the proof when done, and whether the proof "
+                   "was verified)\n";
+        content += "- List the jobs: /jobs (queued, proving and recently finished)\n";
         content += "- Status of the server: /status (busy proving a block or not)\n";
-        content += "- Info of the server: /info (which blocks can be proven)\n";
+        content += "- Info of the server: /info (which block sizes are loaded)\n";
+        content += "- Metrics: /metrics (latencies per stage, queue and memory usage, Prometheus format)\n";
         content += "- Shut down the server: /stop (will first finish generating "
-                   "the proof if busy)\n";
+                   "the proof if busy, queued blocks are dropped)\n";
         res.set_content(content, "text/plain");
     });
 
     std::cout << "Running server on 'localhost' on port " << port << std::endl;
     svr.listen("0.0.0.0", port);
+
+    jobQueue.stop();
+    witnessWorker.join();
+    proverWorker.join();
+    verifierWorker.join();
 }
 
 std::string& replace_all(std::string& str,const std::string& old_value,const std::string& new_value)
@@ -563,10 +1609,10 @@ bool runBenchmark(Loopring::Circuit *circuit, const std::string &provingKeyFilen
     // Load the proving key
     ProverContextT context;
     loadProvingKey(provingKeyFilename, context.provingKey);
-    context.constraint_system = &(circuit->getPb().constraint_system);
+    context.constraint_system = &(circuit->getProvingPb().constraint_system);
 
     VerificationKeyT vk =
-      loadVerificationKey(provingKeyFilename.substr(0, provingKeyFilename.length() - 6) + "vk.json");
+      loadVerificationKey(getVerificationKeyFilename(provingKeyFilename));
 
     if (!validateCircuit(circuit))
     {
@@ -640,7 +1686,7 @@ bool runBenchmark(Loopring::Circuit *circuit, const std::string &provingKeyFilen
 #endif
 
         context.config = config;
-        context.domain = get_domain(circuit->getPb(), context.provingKey, config);
+        context.domain = get_domain(circuit->getProvingPb(), context.provingKey, config);
         initProverContextBuffers(context);
 
         unsigned int totalTime = 0;
@@ -704,8 +1750,16 @@ int main(int argc, char **argv)
     {
         std::cerr << "Usage: " << argv[0] << std::endl;
         std::cerr << "-validate <block.json>: Validates a block" << std::endl;
+        std::cerr << "-precheck <block.json>: Quickly checks the Merkle proofs, state roots and "
+                     "transaction rules (except signatures) of a block without building the circuit"
+                  << std::endl;
+        std::cerr << "-selectsize <block.json>: Prints the block size a block with blockSize 0 is padded to "
+                     "(the smallest block size with keys the transactions fit in)"
+                  << std::endl;
         std::cerr << "-prove <block.json> <out_proof.json>: Proves a block" << std::endl;
-        std::cerr << "-createkeys <protoBlock.json>: Creates prover/verifier keys" << std::endl;
+        std::cerr << "-createkeys <protoBlock.json>: Creates prover/verifier keys "
+                     "(the constraint system is cached in <keys>/<name>_keygen_r1cs.bin)"
+                  << std::endl;
         std::cerr << "-verify <vk.json> <proof.json>: Verify a proof" << std::endl;
         std::cerr << "-exportcircuit <block.json> <circuit.json>: Exports the rc1s "
                      "circuit to json (circom - not all fields)"
@@ -722,8 +1776,22 @@ int main(int argc, char **argv)
         std::cerr << "-pk_mcl2nozk <pk_mlc.raw> <pk_nozk.raw>: Converts the "
                      "proving key from the mcl format to the nozk format"
                   << std::endl;
-        std::cerr << "-server <block.json> <port>: Keeps the program running as an "
-                     "HTTP server to prove blocks on demand"
+        std::cerr << "-pk_raw2bulk <pk.raw> <pk.bulk>: Converts the proving key "
+                     "to the bulk format, which loads the points without decoding them "
+                     "(used instead of <name>_pk.raw when <name>_pk.bulk exists, only valid for "
+                     "builds with the same curve)"
+                  << std::endl;
+        std::cerr << "-block2bin <block.json> <block.bin>: Converts the block to the binary "
+                     "block format, accepted everywhere a block.json is"
+                  << std::endl;
+        std::cerr << "-server <block.json> <port> [queue_size] [num_circuits]: Keeps the program running as an "
+                     "HTTP server to prove blocks on demand (num_circuits=2 generates the next witness "
+                     "while proving, other block sizes and a memory budget can be set in server.json)"
+                  << std::endl;
+        std::cerr << "-circuitstats <block.json> <stats.json>: Writes the constraints and variables "
+                     "of the circuit by gadget class and gadget path"
+                  << std::endl;
+        std::cerr << "-circuitstatsdiff <before.json> <after.json>: Compares the circuit stats of two builds"
                   << std::endl;
         std::cerr << "-benchmark <block.json>: Try out multiple prover options to "
                      "find the fastest configuration on the system"
@@ -733,18 +1801,29 @@ int main(int argc, char **argv)
 
     const char *proofFilename = NULL;
     Mode mode = Mode::Validate;
+    ServerConfig serverConfig;
 
     #ifdef ZKP_WORKER_MODE
-        std::string baseFilename = "/data/keys/";
+        const std::string keysFolder = "/data/keys/";
     #else
-        std::string baseFilename = "keys/";
+        const std::string keysFolder = "keys/";
     #endif
+    std::string baseFilename = keysFolder;
 
     if (strcmp(argv[1], "-validate") == 0)
     {
         mode = Mode::Validate;
         std::cout << "Validating " << argv[2] << "..." << std::endl;
     }
+    else if (strcmp(argv[1], "-precheck") == 0)
+    {
+        mode = Mode::Precheck;
+        std::cout << "Prechecking " << argv[2] << "..." << std::endl;
+    }
+    else if (strcmp(argv[1], "-selectsize") == 0)
+    {
+        mode = Mode::SelectSize;
+    }
     else if (strcmp(argv[1], "-prove") == 0)
     {
         if (argc != 4)
@@ -781,6 +1860,25 @@ int main(int argc, char **argv)
         std::cout << "Proof is valid" << std::endl;
         return 0;
     }
+    else if (strcmp(argv[1], "-circuitstats") == 0)
+    {
+        if (argc != 4)
+        {
+            std::cout << "Invalid number of arguments!" << std::endl;
+            return 1;
+        }
+        mode = Mode::CircuitStats;
+        std::cout << "Collecting circuit stats for " << argv[2] << "..." << std::endl;
+    }
+    else if (strcmp(argv[1], "-circuitstatsdiff") == 0)
+    {
+        if (argc != 4)
+        {
+            std::cout << "Invalid number of arguments!" << std::endl;
+            return 1;
+        }
+        return compareCircuitStats(argv[2], argv[3]) ? 0 : 1;
+    }
     else if (strcmp(argv[1], "-exportcircuit") == 0)
     {
         if (argc != 4)
@@ -848,14 +1946,59 @@ int main(int argc, char **argv)
         std::cout << "Successfully created pk " << argv[3] << "." << std::endl;
         return 0;
     }
-    else if (strcmp(argv[1], "-server") == 0)
+    else if (strcmp(argv[1], "-pk_raw2bulk") == 0)
+    {
+        if (argc != 4)
+        {
+            std::cout << "Invalid number of arguments!" << std::endl;
+            return 1;
+        }
+        std::cout << "Converting pk from " << argv[2] << " to " << argv[3] << " ..." << std::endl;
+        if (!pk_raw2bulk(argv[2], argv[3]))
+        {
+            std::cout << "Failed to convert!" << std::endl;
+            return 1;
+        }
+        std::cout << "Successfully created pk " << argv[3] << "." << std::endl;
+        return 0;
+    }
+    else if (strcmp(argv[1], "-block2bin") == 0)
     {
         if (argc != 4)
         {
             std::cout << "Invalid number of arguments!" << std::endl;
             return 1;
         }
+        std::cout << "Converting block " << argv[2] << " to " << argv[3] << " ..." << std::endl;
+        auto begin = now();
+        if (!block2bin(argv[2], argv[3]))
+        {
+            std::cout << "Failed to convert!" << std::endl;
+            return 1;
+        }
+        print_time(begin, "Block converted");
+        return 0;
+    }
+    else if (strcmp(argv[1], "-server") == 0)
+    {
+        if (argc < 4 || argc > 6)
+        {
+            std::cout << "Invalid number of arguments!" << std::endl;
+            return 1;
+        }
         mode = Mode::Server;
+        if (fileExists("server.json"))
+        {
+            serverConfig = loadJSON("server.json").get<ServerConfig>();
+        }
+        if (argc >= 5)
+        {
+            serverConfig.queue_size = std::stoi(argv[4]);
+        }
+        if (argc >= 6)
+        {
+            serverConfig.num_circuits = std::max(1, std::stoi(argv[5]));
+        }
         std::cout << "Starting proving server for " << argv[2] << " on port " << argv[3] << "..." << std::endl;
     }
     else if (strcmp(argv[1], "-benchmark") == 0)
@@ -886,28 +2029,57 @@ int main(int argc, char **argv)
 
     // Read the block file
     std::cout << "in main before loadJSON" << std::endl;
-    json input = loadJSON(argv[2]);
-    std::cout << "in main after loadJSON" << std::endl;
-    if (input == json())
+    BlockInput input;
+    if (!loadBlockInput(argv[2], input))
     {
         return 1;
     }
+    std::cout << "in main after loadJSON" << std::endl;
 
-    // Read meta data
-    int iBlockType = input["blockType"].get<int>();
-    unsigned int blockSize = input["blockSize"].get<int>();
-    std::string postFix = "_" + std::to_string(blockSize);
+    if (mode == Mode::Precheck)
+    {
+        auto begin = now();
+        Loopring::PrecheckResult result = precheckBlock(input);
+        std::cout << "Precheck: " << precheckResultToString(result) << " (" << elapsed_time_s(begin) << "s)"
+                  << std::endl;
+        return result.valid ? 0 : 1;
+    }
 
-    /*if (iBlockType >= int(Loopring::BlockType::COUNT))
+    // Read meta data
+    int iBlockType = input.blockType;
+    if (iBlockType < 0 || iBlockType >= int(Loopring::BlockType::COUNT))
     {
         std::cerr << "Invalid block type: " << iBlockType << std::endl;
         return 1;
-    }*/
-    unsigned int blockType = iBlockType;
+    }
+    unsigned int blockType = Loopring::getCircuitBlockType(iBlockType);
+
+    // Blocks without a block size are padded, in server mode every submitted block is
+    if (mode != Mode::Server)
+    {
+        std::string error;
+        if (!padBlockInput(input, getAvailableBlockSizes(keysFolder, blockType), error))
+        {
+            std::cerr << error;
+            return 1;
+        }
+    }
+    if (mode == Mode::SelectSize)
+    {
+        std::cout << "Block size: " << input.blockSize << std::endl;
+        return 0;
+    }
+    unsigned int blockSize = input.blockSize;
+    std::string postFix = "_" + std::to_string(blockSize);
     baseFilename += getBaseName(blockType) + postFix;
     std::string provingKeyFilename = getProvingKeyFilename(baseFilename);
 
-    if (mode == Mode::Prove || mode == Mode::Server)
+    if (mode == Mode::CircuitStats)
+    {
+        return writeCircuitStats(blockType, blockSize, argv[3]) ? 0 : 1;
+    }
+
+    if (mode == Mode::Prove || (mode == Mode::Server && blockSize != 0))
     {
         if (!fileExists(provingKeyFilename))
         {
@@ -916,15 +2088,70 @@ int main(int argc, char **argv)
         }
     }
 
+    if (mode == Mode::Server)
+    {
+#ifdef MULTICORE
+        omp_set_num_threads(config.num_threads);
+        std::cout << "Num threads used: " << omp_get_max_threads() << std::endl;
+#endif
+        // Circuits are created by the registry, load the requested block sizes up front
+        ProverRegistry registry(keysFolder, config, serverConfig.num_circuits, serverConfig.memory_budget_mb);
+        std::vector<unsigned int> blockSizes;
+        if (blockSize != 0)
+        {
+            blockSizes.push_back(blockSize);
+        }
+        blockSizes.insert(blockSizes.end(), serverConfig.block_sizes.begin(), serverConfig.block_sizes.end());
+        for (unsigned int size : blockSizes)
+        {
+            std::string error;
+            ProverInstance *instance = registry.acquire(blockType, size, error);
+            if (instance == nullptr)
+            {
+                std::cerr << "Failed to load block size " << size << ": " << error << std::endl;
+                return 1;
+            }
+            registry.release(instance);
+        }
+
+        runServer(
+          registry,
+          std::stoi(argv[3]),
+          serverConfig.queue_size,
+          serverConfig.verify_mode,
+          serverConfig.precheck);
+        pthread_exit(NULL);
+    }
+
+    // Key generation cache: -createkeys and -exportcircuit only need the constraint
+    // system, so they load it from the cache instead of building the circuit.
+    // Every other mode (validate, prove, server) needs the witness, and the gadgets
+    // generating it are only created together with their constraints, so these
+    // always build the circuit and don't use the cache.
     ethsnarks::ProtoboardT pb;
-    Loopring::Circuit *circuit = createCircuit(blockType, blockSize, pb);
-    if (config.swapAB)
+    Loopring::Circuit *circuit = nullptr;
+    bool constraintsOnly = (mode == Mode::CreateKeys || mode == Mode::ExportCircuit);
+    std::string constraintsFilename = getKeygenConstraintSystemFilename(baseFilename);
+    if (constraintsOnly && loadConstraintSystem(constraintsFilename, blockType, blockSize, pb))
     {
-        // pb.constraint_system.swap_AB_if_beneficial();
+#ifdef OPTIMIZE_R1CS
+        pb = std::move(Loopring::OptimizedConstraintSystem(pb).pb);
+#endif
+        shrinkCircuit(pb, config);
     }
-    pb.constraint_system.constraints.shrink_to_fit();
-    pb.values.shrink_to_fit();
-    libsnark::ConstantStorage<FieldT>::getInstance().constants.shrink_to_fit();
+    else
+    {
+        pb = ethsnarks::ProtoboardT();
+        circuit = createCircuit(blockType, blockSize, pb);
+        shrinkCircuit(pb, config);
+        if (constraintsOnly && Loopring::writeConstraintSystem(pb, blockType, blockSize, constraintsFilename))
+        {
+            std::cout << "Constraint system cached for key generation in " << constraintsFilename << std::endl;
+        }
+    }
+
+    // The constraint system the keys and proofs are for
+    ethsnarks::ProtoboardT &provingPb = (circuit != nullptr) ? circuit->getProvingPb() : pb;
 
     printMemoryUsage();
 
@@ -954,21 +2181,6 @@ int main(int argc, char **argv)
     std::cout << "Num threads used: " << omp_get_max_threads() << std::endl;
 #endif
 
-    if (mode == Mode::Server)
-    {
-    	// Setup the context a single time
-    	ProverContextT context;
-    	loadProvingKey(provingKeyFilename, context.provingKey);
-    	context.constraint_system = &(circuit->getPb().constraint_system);
-    	context.config = config;
-    	context.domain = get_domain(circuit->getPb(), context.provingKey, config);
-    	initProverContextBuffers(context);
-
-//        pthread_t tid;
-
-        runServer(context, circuit, provingKeyFilename, config, std::stoi(argv[3]));
-    }
-
     if (mode == Mode::Validate || mode == Mode::Prove)
     {
         if (!generateWitness(circuit, input))
@@ -987,7 +2199,7 @@ int main(int argc, char **argv)
 
     if (mode == Mode::CreateKeys)
     {
-        if (!generateKeyPair(pb, baseFilename))
+        if (!generateKeyPair(provingPb, baseFilename))
         {
             std::cerr << "Failed to generate keys!" << std::endl;
             return 1;
@@ -1000,14 +2212,14 @@ int main(int argc, char **argv)
         std::cout << "GPU Prove: Generate inputsFile." << std::endl;
         std::string inputsFilename = baseFilename + "_inputs.raw";
         auto begin = now();
-        stub_write_input_from_pb(pb, provingKeyFilename.c_str(), inputsFilename.c_str());
+        stub_write_input_from_pb(provingPb, provingKeyFilename.c_str(), inputsFilename.c_str());
         print_time(begin, "write input");
 #else
         ProverContextT context;
         loadProvingKey(provingKeyFilename, context.provingKey);
-        context.constraint_system = &pb.constraint_system;
+        context.constraint_system = &provingPb.constraint_system;
         context.config = config;
-        context.domain = get_domain(pb, context.provingKey, config);
+        context.domain = get_domain(provingPb, context.provingKey, config);
         initProverContextBuffers(context);
         printMemoryUsage();
         std::string jProof = proveCircuit(context, circuit);
@@ -1020,7 +2232,7 @@ int main(int argc, char **argv)
             return 1;
         }
 
-        VerificationKeyT vk = loadVerificationKey(provingKeyFilename.substr(0, provingKeyFilename.length() - 6) + "vk.json");
+        VerificationKeyT vk = loadVerificationKey(getVerificationKeyFilename(provingKeyFilename));
         std::stringstream proof_stream;
         proof_stream << jProof;
         auto proof_pair = proof_from_json(proof_stream);
@@ -1033,7 +2245,7 @@ int main(int argc, char **argv)
 
     if (mode == Mode::ExportCircuit)
     {
-        if (!r1cs2json(pb, argv[3]))
+        if (!r1cs2json(provingPb, argv[3]))
         {
             std::cerr << "Failed to export circuit!" << std::endl;
             return 1;
@@ -1042,7 +2254,7 @@ int main(int argc, char **argv)
 
     if (mode == Mode::ExportWitness)
     {
-        if (!witness2json(pb, argv[3]))
+        if (!witness2json(provingPb, argv[3]))
         {
             std::cerr << "Failed to export witness!" << std::endl;
             return 1;
@@ -0,0 +1,77 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/BinaryBlock.h"
+
+TEST_CASE("BinaryBlock", "[BinaryBlock]")
+{
+    const std::string filename = "test_block.bin";
+
+    Block block;
+    block.exchange = getRandomFieldElement(160);
+    block.merkleRootBefore = getRandomFieldElement();
+    block.merkleRootAfter = getRandomFieldElement();
+    block.merkleAssetRootBefore = getRandomFieldElement();
+    block.merkleAssetRootAfter = getRandomFieldElement();
+    block.timestamp = FieldT(1600000000);
+    block.protocolFeeBips = FieldT(18);
+    block.signature = dummySignature.get<Signature>();
+    block.operatorAccountID = FieldT(3);
+    block.accountUpdate_O.proof.data = {getRandomFieldElement(), getRandomFieldElement()};
+    block.accountUpdate_O.before.publicKey.x = getRandomFieldElement();
+
+    UniversalTransaction transaction;
+    transaction.type = FieldT(int(TransactionType::Transfer));
+    transaction.spotTrade = dummySpotTrade.get<SpotTrade>();
+    transaction.batchSpotTrade = dummyBatchSpotTrade.get<BatchSpotTrade>();
+    transaction.transfer = dummyTransfer.get<Transfer>();
+    transaction.transfer.amount = getRandomFieldElement(96);
+    transaction.witness.storageUpdate_C_array.resize(2);
+    transaction.witness.storageUpdate_C_array[1].before.storageID = FieldT(7);
+    transaction.witness.signatureArray = {{dummySignature.get<Signature>()}};
+    block.transactions.push_back(transaction);
+    block.transactions.push_back(transaction);
+
+    REQUIRE(writeBinaryBlock(block, 0, 2, filename));
+    REQUIRE(isBinaryBlock(filename));
+
+    SECTION("round trip")
+    {
+        Block loaded;
+        unsigned int blockType = 1;
+        unsigned int blockSize = 0;
+        REQUIRE(readBinaryBlock(filename, loaded, blockType, blockSize));
+        REQUIRE(blockType == 0);
+        REQUIRE(blockSize == 2);
+        REQUIRE((loaded.exchange == block.exchange));
+        REQUIRE((loaded.merkleAssetRootAfter == block.merkleAssetRootAfter));
+        REQUIRE((loaded.timestamp == block.timestamp));
+        REQUIRE((loaded.signature.R.y == block.signature.R.y));
+        REQUIRE((loaded.accountUpdate_O.proof.data == block.accountUpdate_O.proof.data));
+        REQUIRE((loaded.accountUpdate_O.before.publicKey.x == block.accountUpdate_O.before.publicKey.x));
+        REQUIRE(loaded.transactions.size() == 2);
+
+        const UniversalTransaction &tx = loaded.transactions[1];
+        REQUIRE((tx.type == transaction.type));
+        REQUIRE((tx.transfer.amount == transaction.transfer.amount));
+        REQUIRE((tx.transfer.putAddressesInDA == transaction.transfer.putAddressesInDA));
+        REQUIRE((tx.spotTrade.orderB.amountS == transaction.spotTrade.orderB.amountS));
+        REQUIRE(tx.batchSpotTrade.users.size() == transaction.batchSpotTrade.users.size());
+        REQUIRE(tx.batchSpotTrade.users[2].orders.size() == transaction.batchSpotTrade.users[2].orders.size());
+        REQUIRE(tx.witness.storageUpdate_C_array.size() == 2);
+        REQUIRE((tx.witness.storageUpdate_C_array[1].before.storageID == FieldT(7)));
+        REQUIRE(tx.witness.signatureArray.size() == 1);
+        REQUIRE((tx.witness.signatureArray[0][0].s == transaction.witness.signatureArray[0][0].s));
+    }
+
+    SECTION("truncated")
+    {
+        std::ifstream in(filename, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        Block loaded;
+        unsigned int blockType, blockSize;
+        REQUIRE(!readBinaryBlock((const uint8_t *)data.data(), data.size() - 1, loaded, blockType, blockSize));
+    }
+
+    std::remove(filename.c_str());
+}
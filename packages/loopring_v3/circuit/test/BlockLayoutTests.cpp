@@ -0,0 +1,52 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/BlockLayout.h"
+
+TEST_CASE("BlockLayout", "[BlockLayout]")
+{
+    auto countFull = [](const BlockLayout &layout, unsigned int blockSize) {
+        unsigned int numFull = 0;
+        for (unsigned int i = 0; i < blockSize; i++)
+        {
+            numFull += layout.isFull(i) ? 1 : 0;
+        }
+        return numFull;
+    };
+
+    for (unsigned int blockSize : {1u, 2u, 7u, 8u, 16u, 64u, 100u})
+    {
+        REQUIRE(countFull(getBlockLayout((unsigned int)BlockType::Universal, blockSize), blockSize) == blockSize);
+        REQUIRE(countFull(getBlockLayout((unsigned int)BlockType::Light, blockSize), blockSize) == 0);
+
+        BlockLayout mixed = getBlockLayout((unsigned int)BlockType::Mixed, blockSize);
+        REQUIRE(countFull(mixed, blockSize) == std::max(1u, blockSize / 8));
+        // Light slots on both sides for deposits and withdrawals
+        REQUIRE(mixed.firstFull == (blockSize - mixed.numFull) / 2);
+    }
+
+    REQUIRE(getBlockTypeName((unsigned int)BlockType::Universal) == "all");
+    REQUIRE(getBlockTypeName((unsigned int)BlockType::Light) == "light");
+    REQUIRE(getBlockTypeName((unsigned int)BlockType::Mixed) == "mixed");
+
+    // The block types used before the light and mixed layouts
+    for (unsigned int blockType : {0u, 1u, 2u, 3u})
+    {
+        REQUIRE(getCircuitBlockType(blockType) == (unsigned int)BlockType::Universal);
+        REQUIRE(getBlockTypeName(blockType) == "all");
+        REQUIRE(countFull(getBlockLayout(blockType, 16), 16) == 16);
+    }
+    REQUIRE(getCircuitBlockType((unsigned int)BlockType::Light) == (unsigned int)BlockType::Light);
+    REQUIRE(getCircuitBlockType((unsigned int)BlockType::Mixed) == (unsigned int)BlockType::Mixed);
+
+    REQUIRE(isLightTransactionType(TransactionType::Noop));
+    REQUIRE(isLightTransactionType(TransactionType::Transfer));
+    REQUIRE(isLightTransactionType(TransactionType::Deposit));
+    REQUIRE(isLightTransactionType(TransactionType::AccountUpdate));
+    REQUIRE(isLightTransactionType(TransactionType::Withdrawal));
+    REQUIRE(!isLightTransactionType(TransactionType::SpotTrade));
+    REQUIRE(!isLightTransactionType(TransactionType::OrderCancel));
+    REQUIRE(!isLightTransactionType(TransactionType::AppKeyUpdate));
+    REQUIRE(!isLightTransactionType(TransactionType::BatchSpotTrade));
+    REQUIRE(getSlotTransactionTypes(true).size() == (unsigned int)TransactionType::COUNT);
+}
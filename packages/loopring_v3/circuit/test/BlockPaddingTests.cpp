@@ -0,0 +1,69 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/BlockPadding.h"
+
+TEST_CASE("BlockPadding", "[BlockPadding]")
+{
+    auto newBlock = [](const std::vector<TransactionType> &types) {
+        Block block;
+        for (unsigned int i = 0; i < types.size(); i++)
+        {
+            UniversalTransaction transaction;
+            transaction.type = FieldT((unsigned int)types[i]);
+            // Tags the transactions to check the order after padding
+            transaction.witness.numConditionalTransactionsAfter = FieldT(i);
+            block.transactions.push_back(transaction);
+        }
+        return block;
+    };
+    auto getTypes = [](const Block &block) {
+        std::vector<TransactionType> types;
+        for (const UniversalTransaction &transaction : block.transactions)
+        {
+            types.push_back(getTransactionType(transaction));
+        }
+        return types;
+    };
+
+    const unsigned int universal = (unsigned int)BlockType::Universal;
+    const TransactionType D = TransactionType::Deposit;
+    const TransactionType T = TransactionType::Transfer;
+    const TransactionType S = TransactionType::SpotTrade;
+    const TransactionType N = TransactionType::Noop;
+    const TransactionType W = TransactionType::Withdrawal;
+
+    SECTION("Padded before the withdrawals")
+    {
+        Block block = newBlock({D, T, N, W, W});
+        REQUIRE(getPaddingPosition(block) == 3);
+        REQUIRE(canPadBlock(block));
+
+        REQUIRE(selectBlockSize(block, universal, {16, 8, 4}) == 8);
+        padBlock(block, 8);
+        REQUIRE((getTypes(block) == std::vector<TransactionType>({D, T, N, N, N, N, W, W})));
+        REQUIRE((block.transactions[5].witness.numConditionalTransactionsAfter == FieldT(2)));
+        REQUIRE((block.transactions[7].witness.numConditionalTransactionsAfter == FieldT(4)));
+    }
+
+    SECTION("Exact block size")
+    {
+        Block block = newBlock({D, T, S, W});
+        REQUIRE(!canPadBlock(block));
+        REQUIRE(selectBlockSize(block, universal, {4, 8}) == 4);
+        REQUIRE(selectBlockSize(block, universal, {8}) == 0);
+        REQUIRE(selectBlockSize(newBlock({D, T, S, N, W}), universal, {4}) == 0);
+    }
+
+    SECTION("Light slots")
+    {
+        const unsigned int light = (unsigned int)BlockType::Light;
+        const unsigned int mixed = (unsigned int)BlockType::Mixed;
+        REQUIRE(selectBlockSize(newBlock({D, T, N, W}), light, {4}) == 4);
+        REQUIRE(selectBlockSize(newBlock({D, S, N, W}), light, {4, 8}) == 0);
+
+        // The full slot of a mixed block of 8 is slot 3
+        REQUIRE(selectBlockSize(newBlock({D, T, T, S, N}), mixed, {8}) == 8);
+        REQUIRE(selectBlockSize(newBlock({D, T, S, N}), mixed, {8}) == 0);
+    }
+}
@@ -0,0 +1,108 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Gadgets/MerkleTree.h"
+#include "../Utils/BlockPrecheck.h"
+
+// Index of the first transaction of the given type, -1 if there is none
+static int findTransaction(const Block &block, TransactionType type)
+{
+    for (unsigned int i = 0; i < block.transactions.size(); i++)
+    {
+        if (block.transactions[i].type == FieldT(int(type)))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+TEST_CASE("BlockPrecheck", "[BlockPrecheck]")
+{
+    SECTION("Merkle root matches the circuit")
+    {
+        const unsigned int depth = 4;
+        for (unsigned int address : {0u, 1u, 2u, 3u, 27u, 147u, 255u})
+        {
+            protoboard<FieldT> pb;
+            VariableArrayT addressBits = make_var_array(pb, depth * 2, "address");
+            VariableT leaf = make_variable(pb, "leaf");
+            VariableArrayT path = make_var_array(pb, depth * 3, "path");
+            MerklePathT merklePath(pb, depth, addressBits, leaf, path, "merklePath");
+            merklePath.generate_r1cs_constraints();
+
+            Proof proof;
+            addressBits.fill_with_bits_of_field_element(pb, FieldT(address));
+            pb.val(leaf) = getRandomFieldElement();
+            for (unsigned int i = 0; i < path.size(); i++)
+            {
+                proof.data.push_back(getRandomFieldElement());
+                pb.val(path[i]) = proof.data.back();
+            }
+            merklePath.generate_r1cs_witness();
+
+            REQUIRE(pb.is_satisfied());
+            REQUIRE((BlockPrecheck::getMerkleRoot(pb.val(leaf), address, proof, depth) == pb.val(merklePath.result())));
+        }
+    }
+
+    Block block = getBlock();
+    const int spotTrade = findTransaction(block, TransactionType::SpotTrade);
+    REQUIRE(spotTrade >= 0);
+    UniversalTransaction &tx = block.transactions[spotTrade];
+
+    SECTION("Valid block")
+    {
+        PrecheckResult result = BlockPrecheck::check(block);
+        INFO(result.error);
+        REQUIRE(result.valid);
+    }
+
+    SECTION("Invalid proof")
+    {
+        block.transactions[1].witness.balanceUpdateB_A.proof.data[5] += 1;
+        PrecheckResult result = BlockPrecheck::check(block);
+        REQUIRE(!result.valid);
+        REQUIRE(result.transaction == 1);
+    }
+
+    SECTION("Invalid state after the block")
+    {
+        block.merkleRootAfter += 1;
+        PrecheckResult result = BlockPrecheck::check(block);
+        REQUIRE(!result.valid);
+        REQUIRE(result.transaction == -1);
+    }
+
+    SECTION("Expired order")
+    {
+        tx.spotTrade.orderA.validUntil = block.timestamp;
+        PrecheckResult result = BlockPrecheck::check(block);
+        REQUIRE(!result.valid);
+        REQUIRE(result.transaction == spotTrade);
+    }
+
+    SECTION("Fee above maxFee")
+    {
+        tx.spotTrade.orderB.fee = tx.spotTrade.orderB.maxFee + 1;
+        PrecheckResult result = BlockPrecheck::check(block);
+        REQUIRE(!result.valid);
+        REQUIRE(result.transaction == spotTrade);
+    }
+
+    SECTION("Trading fee above feeBips")
+    {
+        tx.spotTrade.orderA.tradingFee = getMaxFieldElement(NUM_BITS_AMOUNT);
+        PrecheckResult result = BlockPrecheck::check(block);
+        REQUIRE(!result.valid);
+        REQUIRE(result.transaction == spotTrade);
+    }
+
+    SECTION("Storage ID smaller than the storage slot")
+    {
+        tx.witness.storageUpdate_A.before.storageID = tx.spotTrade.orderA.storageID + FieldT(NUM_STORAGE_SLOTS);
+        PrecheckResult result = BlockPrecheck::check(block);
+        REQUIRE(!result.valid);
+        REQUIRE(result.transaction == spotTrade);
+    }
+}
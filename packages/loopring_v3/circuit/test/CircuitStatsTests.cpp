@@ -0,0 +1,82 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/CircuitStats.h"
+
+// x_{i+1} = x_i * x_i for `n` new variables
+struct SquaresGadget
+{
+    ProtoboardT &pb;
+    VariableArrayT x;
+
+    SquaresGadget(ProtoboardT &_pb, unsigned int n) : pb(_pb), x(make_var_array(_pb, n + 1, "x"))
+    {
+    }
+
+    void generate_r1cs_constraints()
+    {
+        for (unsigned int i = 0; i + 1 < x.size(); i++)
+        {
+            pb.add_r1cs_constraint(ConstraintT(x[i], x[i], x[i + 1]), "x");
+        }
+    }
+};
+
+struct NestedGadget
+{
+    SquaresGadget inner;
+    SquaresGadget outer;
+
+    NestedGadget(ProtoboardT &pb) : inner(pb, 3), outer(pb, 2)
+    {
+    }
+
+    void generate_r1cs_constraints()
+    {
+        PROFILE_CONSTRAINTS(inner);
+        outer.generate_r1cs_constraints();
+    }
+};
+
+TEST_CASE("CircuitStats", "[CircuitStats]")
+{
+    protoboard<FieldT> pb;
+    NestedGadget nested(pb);
+    SquaresGadget squares(pb, 4);
+
+    ConstraintProfiler profiler(pb);
+    ConstraintProfiler::generate(nested, "nested");
+    ConstraintProfiler::generate(squares, "squares");
+    pb.add_r1cs_constraint(ConstraintT(squares.x[0], squares.x[1], nested.inner.x[0]), "unprofiled");
+    CircuitStats stats = profiler.getStats();
+
+    REQUIRE(stats.constraints == 3 + 2 + 4 + 1);
+    REQUIRE(stats.byPath["nested"].constraints == 5);
+    REQUIRE(stats.byPath["nested"].variables == 4 + 3);
+    REQUIRE(stats.byPath["nested.inner"].constraints == 3);
+    REQUIRE(stats.byPath["nested.inner"].variables == 4);
+    REQUIRE(stats.byPath["squares"].constraints == 4);
+    REQUIRE(stats.byPath["(unprofiled)"].constraints == 1);
+    REQUIRE(stats.byPath["(unprofiled)"].variables == 0);
+
+    // Both SquaresGadget instances
+    REQUIRE(stats.byClass["SquaresGadget"].instances == 2);
+    REQUIRE(stats.byClass["SquaresGadget"].constraints == 3 + 4);
+
+    SECTION("json")
+    {
+        CircuitStats loaded = json(stats).get<CircuitStats>();
+        REQUIRE(loaded.constraints == stats.constraints);
+        REQUIRE(loaded.byPath["nested.inner"].variables == 4);
+    }
+
+    SECTION("diff")
+    {
+        CircuitStats after = stats;
+        after.constraints -= 2;
+        after.byClass["SquaresGadget"].constraints -= 2;
+        std::string diff = diffCircuitStats(stats, after);
+        REQUIRE(diff.find("class SquaresGadget") != std::string::npos);
+        REQUIRE(diff.find("path squares") == std::string::npos);
+    }
+}
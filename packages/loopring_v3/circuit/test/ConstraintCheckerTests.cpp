@@ -0,0 +1,39 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/ConstraintChecker.h"
+
+TEST_CASE("ConstraintChecker", "[ConstraintChecker]")
+{
+    // Enough constraints for multiple chunks: x_{i+1} = x_i * x_i + 1
+    const unsigned int numConstraints = 3 * ConstraintChecker::CHUNK_SIZE + 5;
+    protoboard<FieldT> pb;
+    VariableArrayT x = make_var_array(pb, numConstraints + 1, "x");
+    for (unsigned int i = 0; i < numConstraints; i++)
+    {
+        pb.add_r1cs_constraint(ConstraintT(x[i], x[i], x[i + 1] - 1), "x");
+    }
+    pb.val(x[0]) = FieldT(3);
+    for (unsigned int i = 0; i < numConstraints; i++)
+    {
+        pb.val(x[i + 1]) = pb.val(x[i]) * pb.val(x[i]) + 1;
+    }
+
+    SECTION("satisfied")
+    {
+        REQUIRE(ConstraintChecker::findFirstUnsatisfied(pb) == numConstraints);
+        REQUIRE(pb.is_satisfied());
+    }
+
+    SECTION("first unsatisfied constraint")
+    {
+        // Breaks constraints 2 * CHUNK_SIZE + 7 and 2 * CHUNK_SIZE + 8
+        pb.val(x[2 * ConstraintChecker::CHUNK_SIZE + 8]) += 1;
+        // Breaks constraints numConstraints - 2 and numConstraints - 1
+        pb.val(x[numConstraints - 1]) += 1;
+        REQUIRE(ConstraintChecker::findFirstUnsatisfied(pb) == 2 * ConstraintChecker::CHUNK_SIZE + 7);
+        REQUIRE(!ConstraintChecker::isSatisfied(pb, 2 * ConstraintChecker::CHUNK_SIZE + 8));
+        REQUIRE(ConstraintChecker::isSatisfied(pb, 2 * ConstraintChecker::CHUNK_SIZE + 9));
+        REQUIRE(!pb.is_satisfied());
+    }
+}
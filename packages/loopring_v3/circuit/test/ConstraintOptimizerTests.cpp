@@ -0,0 +1,79 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Gadgets/MathGadgets.h"
+#include "../Utils/ConstraintOptimizer.h"
+
+TEST_CASE("ConstraintOptimizer", "[ConstraintOptimizer]")
+{
+    SECTION("passes")
+    {
+        protoboard<FieldT> pb;
+        VariableT y = make_variable(pb, "y");
+        pb.set_input_sizes(1);
+        VariableT x = make_variable(pb, "x");
+        VariableT a = make_variable(pb, "a");
+        VariableT b = make_variable(pb, "b");
+        VariableT bit = make_variable(pb, "bit");
+        make_variable(pb, "unused");
+
+        // a = x + 3, linear
+        pb.add_r1cs_constraint(ConstraintT(1, x + 3, a), "a");
+        // b = a * a, twice
+        pb.add_r1cs_constraint(ConstraintT(a, a, b), "b");
+        pb.add_r1cs_constraint(ConstraintT(a, a, b), "b");
+        // y = b + bit, linear but y is a primary input
+        pb.add_r1cs_constraint(ConstraintT(b + bit, 1, y), "y");
+        // bit is boolean, twice with A and B swapped
+        pb.add_r1cs_constraint(ConstraintT(bit, 1 - bit, 0), "bit");
+        pb.add_r1cs_constraint(ConstraintT(1 - bit, bit, 0), "bit");
+
+        pb.val(x) = 4;
+        pb.val(a) = 7;
+        pb.val(b) = 49;
+        pb.val(bit) = 1;
+        pb.val(y) = 50;
+        REQUIRE(pb.is_satisfied());
+
+        OptimizedConstraintSystem optimized(pb);
+        // a * a = y - bit and bit * (1 - bit) = 0
+        REQUIRE(optimized.pb.num_constraints() == 2);
+        REQUIRE(optimized.pb.num_inputs() == 1);
+        REQUIRE(optimized.stats.duplicates == 2);
+        // y, a and bit
+        REQUIRE(optimized.pb.num_variables() == 3);
+        REQUIRE(optimized.variables[1] == y.index);
+
+        optimized.assign(pb);
+        REQUIRE(optimized.pb.is_satisfied());
+
+        pb.val(bit) = 2;
+        pb.val(y) = 51;
+        optimized.assign(pb);
+        REQUIRE(!optimized.pb.is_satisfied());
+    }
+
+    SECTION("gadget")
+    {
+        protoboard<FieldT> pb;
+        VariableArrayT inputs = make_var_array(pb, 2, "inputs");
+        pb.set_input_sizes(2);
+        Poseidon_2 hash(pb, inputs, "hash");
+        VariableArrayT bits = make_var_array(pb, 32, "bits");
+        libsnark::packing_gadget<FieldT> packing(pb, bits, inputs[0], "packing");
+        hash.generate_r1cs_constraints();
+        packing.generate_r1cs_constraints(true);
+
+        pb.val(inputs[0]) = 123456;
+        pb.val(inputs[1]) = getRandomFieldElement();
+        hash.generate_r1cs_witness();
+        packing.generate_r1cs_witness_from_packed();
+        REQUIRE(pb.is_satisfied());
+
+        OptimizedConstraintSystem optimized(pb);
+        REQUIRE(optimized.pb.num_constraints() < pb.num_constraints());
+        REQUIRE(optimized.pb.num_variables() < pb.num_variables());
+        optimized.assign(pb);
+        REQUIRE(optimized.pb.is_satisfied());
+    }
+}
@@ -0,0 +1,58 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Gadgets/MathGadgets.h"
+#include "../Utils/ConstraintSystemCache.h"
+
+TEST_CASE("ConstraintSystemCache", "[ConstraintSystemCache]")
+{
+    const std::string filename = "test_r1cs_cache.bin";
+
+    protoboard<FieldT> pb;
+    pb_variable<FieldT> A, B;
+    A.allocate(pb, "A");
+    B.allocate(pb, "B");
+    pb.set_input_sizes(1);
+    AddGadget addGadget(pb, A, B, 32, "addGadget");
+    addGadget.generate_r1cs_constraints();
+    pb.add_r1cs_constraint(ConstraintT(A + FieldT(3) * B, FieldT(5), addGadget.result()), "lc");
+
+    REQUIRE(writeConstraintSystem(pb, 0, 8, filename));
+
+    SECTION("round trip")
+    {
+        protoboard<FieldT> cachedPb;
+        REQUIRE(readConstraintSystem(filename, 0, 8, cachedPb));
+        REQUIRE(cachedPb.num_constraints() == pb.num_constraints());
+        REQUIRE(cachedPb.num_inputs() == pb.num_inputs());
+        REQUIRE(cachedPb.num_variables() == pb.num_variables());
+
+        // The same witness needs to satisfy both constraint systems
+        pb.val(A) = FieldT(7);
+        pb.val(B) = FieldT(9);
+        addGadget.generate_r1cs_witness();
+        for (size_t i = 0; i < pb.num_variables(); i++)
+        {
+            cachedPb.val(libsnark::pb_variable<FieldT>(i + 1)) = pb.val(libsnark::pb_variable<FieldT>(i + 1));
+        }
+        REQUIRE(!pb.is_satisfied());
+        REQUIRE(!cachedPb.is_satisfied());
+        pb.val(B) = FieldT(0);
+        pb.val(A) = FieldT(0);
+        addGadget.generate_r1cs_witness();
+        for (size_t i = 0; i < pb.num_variables(); i++)
+        {
+            cachedPb.val(libsnark::pb_variable<FieldT>(i + 1)) = pb.val(libsnark::pb_variable<FieldT>(i + 1));
+        }
+        REQUIRE(pb.is_satisfied());
+        REQUIRE(cachedPb.is_satisfied());
+    }
+
+    SECTION("different block")
+    {
+        protoboard<FieldT> cachedPb;
+        REQUIRE(!readConstraintSystem(filename, 0, 16, cachedPb));
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,46 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/Data.h"
+
+// Cost of filling in the dummy data of 1k transactions.
+// Run with: dex_circuit_tests "[benchmark]"
+TEST_CASE("Dummy transaction data", "[.][benchmark]")
+{
+    const unsigned int numTransactions = 1000;
+    std::vector<UniversalTransaction> transactions(numTransactions);
+
+    BENCHMARK("Parse the dummy json per transaction")
+    {
+        for (UniversalTransaction &transaction : transactions)
+        {
+            transaction.spotTrade = dummySpotTrade.get<SpotTrade>();
+            transaction.batchSpotTrade = dummyBatchSpotTrade.get<BatchSpotTrade>();
+            transaction.transfer = dummyTransfer.get<Transfer>();
+            transaction.withdraw = dummyWithdraw.get<Withdrawal>();
+            transaction.deposit = dummyDeposit.get<Deposit>();
+            transaction.accountUpdate = dummyAccountUpdate.get<AccountUpdateTx>();
+            transaction.orderCancel = dummyOrderCancel.get<OrderCancel>();
+            transaction.appKeyUpdate = dummyAppKeyUpdate.get<AppKeyUpdate>();
+        }
+        return transactions.size();
+    };
+
+    BENCHMARK("Copy the dummy templates per transaction")
+    {
+        for (UniversalTransaction &transaction : transactions)
+        {
+            transaction.spotTrade = getDummySpotTrade();
+            transaction.batchSpotTrade = getDummyBatchSpotTrade();
+            transaction.transfer = getDummyTransfer();
+            transaction.withdraw = getDummyWithdraw();
+            transaction.deposit = getDummyDeposit();
+            transaction.accountUpdate = getDummyAccountUpdate();
+            transaction.orderCancel = getDummyOrderCancel();
+            transaction.appKeyUpdate = getDummyAppKeyUpdate();
+        }
+        return transactions.size();
+    };
+
+    REQUIRE((transactions[0].transfer.amount == getDummyTransfer().amount));
+}
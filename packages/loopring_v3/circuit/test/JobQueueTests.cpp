@@ -0,0 +1,157 @@
+#include "../ThirdParty/catch.hpp"
+
+#include "../Utils/JobQueue.h"
+
+#include <thread>
+
+using namespace Loopring;
+
+static ProverJob newJob(const std::string &blockFilename)
+{
+    ProverJob job;
+    job.blockFilename = blockFilename;
+    return job;
+}
+
+TEST_CASE("JobQueue", "[JobQueue]")
+{
+    SECTION("FIFO order and job ids")
+    {
+        JobQueue jobQueue(4);
+        ProverJob jobA = newJob("a.json");
+        ProverJob jobB = newJob("b.json");
+        REQUIRE(jobQueue.submit(jobA));
+        REQUIRE(jobQueue.submit(jobB));
+        REQUIRE(jobA.id != jobB.id);
+        REQUIRE(jobQueue.numPending() == 2);
+
+        ProverJob job;
+        REQUIRE(jobQueue.pop(job));
+        REQUIRE(job.id == jobA.id);
+        REQUIRE(job.status == JobStatus::Witness);
+        REQUIRE(jobQueue.numPending() == 1);
+
+        jobQueue.setStatus(job.id, JobStatus::Proving);
+        jobQueue.setBlockSize(job.id, 16);
+        REQUIRE(jobQueue.get(jobA.id, job));
+        REQUIRE(job.status == JobStatus::Proving);
+        REQUIRE(job.blockSize == 16);
+
+        jobQueue.finish(job.id, true, "{}");
+        REQUIRE(jobQueue.get(jobA.id, job));
+        REQUIRE(job.status == JobStatus::Done);
+        REQUIRE(job.result == "{}");
+
+        REQUIRE(jobQueue.get(jobB.id, job));
+        REQUIRE(job.status == JobStatus::Queued);
+    }
+
+    SECTION("verification after finish")
+    {
+        JobQueue jobQueue(4);
+        ProverJob jobA = newJob("a.json");
+        ProverJob jobB = newJob("b.json");
+        REQUIRE(jobQueue.submit(jobA));
+        REQUIRE(jobQueue.submit(jobB));
+
+        ProverJob job;
+        REQUIRE(jobQueue.pop(job));
+        jobQueue.finish(job.id, true, "{}", ProofCheck::Pending);
+        REQUIRE(jobQueue.pop(job));
+        jobQueue.finish(job.id, true, "{}", ProofCheck::Pending);
+
+        jobQueue.setProofCheck(jobA.id, true);
+        REQUIRE(jobQueue.get(jobA.id, job));
+        REQUIRE(job.status == JobStatus::Done);
+        REQUIRE(job.proofCheck == ProofCheck::Verified);
+
+        // The job stays done, the failed verification is reported separately
+        jobQueue.setProofCheck(jobB.id, false);
+        REQUIRE(jobQueue.get(jobB.id, job));
+        REQUIRE(job.status == JobStatus::Done);
+        REQUIRE(job.result == "{}");
+        REQUIRE(job.proofCheck == ProofCheck::Invalid);
+        REQUIRE(std::string(proofCheckToString(job.proofCheck)) == "verify_failed");
+
+        // Only a pending verification is reported
+        jobQueue.setProofCheck(jobB.id, true);
+        REQUIRE(jobQueue.get(jobB.id, job));
+        REQUIRE(job.proofCheck == ProofCheck::Invalid);
+    }
+
+    SECTION("bounded")
+    {
+        JobQueue jobQueue(2);
+        ProverJob job = newJob("block.json");
+        REQUIRE(jobQueue.submit(job));
+        REQUIRE(jobQueue.submit(job));
+        REQUIRE(!jobQueue.submit(job));
+    }
+
+    SECTION("finished jobs are evicted")
+    {
+        JobQueue jobQueue(8, 2);
+        std::vector<unsigned int> ids;
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            ProverJob job = newJob("block.json");
+            REQUIRE(jobQueue.submit(job));
+            ids.push_back(job.id);
+            REQUIRE(jobQueue.pop(job));
+            jobQueue.finish(job.id, false, "Error");
+        }
+        ProverJob job;
+        REQUIRE(!jobQueue.get(ids[0], job));
+        REQUIRE(jobQueue.get(ids[1], job));
+        REQUIRE(jobQueue.get(ids[2], job));
+        REQUIRE(job.status == JobStatus::Failed);
+    }
+
+    SECTION("wait on worker")
+    {
+        JobQueue jobQueue(4);
+        std::thread worker([&]() {
+            ProverJob job;
+            while (jobQueue.pop(job))
+            {
+                jobQueue.finish(job.id, true, job.blockFilename);
+            }
+        });
+
+        ProverJob job = newJob("block.json");
+        REQUIRE(jobQueue.submit(job));
+        REQUIRE(jobQueue.wait(job.id, job));
+        REQUIRE(job.status == JobStatus::Done);
+        REQUIRE(job.result == "block.json");
+
+        jobQueue.stop();
+        worker.join();
+    }
+
+    SECTION("stop fails queued jobs")
+    {
+        JobQueue jobQueue(4);
+        ProverJob job = newJob("block.json");
+        REQUIRE(jobQueue.submit(job));
+        jobQueue.stop();
+        REQUIRE(jobQueue.get(job.id, job));
+        REQUIRE(job.status == JobStatus::Failed);
+        REQUIRE(!jobQueue.pop(job));
+        REQUIRE(!jobQueue.submit(job));
+    }
+}
+
+TEST_CASE("Channel", "[Channel]")
+{
+    Channel<unsigned int> channel;
+    channel.push(1);
+    channel.push(2);
+    channel.close();
+
+    unsigned int value;
+    REQUIRE(channel.pop(value));
+    REQUIRE(value == 1);
+    REQUIRE(channel.pop(value));
+    REQUIRE(value == 2);
+    REQUIRE(!channel.pop(value));
+}
@@ -0,0 +1,33 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/Log.h"
+
+TEST_CASE("Log", "[Log]")
+{
+    SECTION("compile-time level")
+    {
+        REQUIRE(Log::compiled(LogError));
+        REQUIRE(Log::compiled(LogInfo) == (LOG_MIN_LEVEL <= LOG_LEVEL_INFO));
+        REQUIRE(Log::compiled(LogDebug) == (LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG));
+        REQUIRE(!Log::compiled(LogLevel::None));
+    }
+
+    SECTION("disabled messages are not evaluated")
+    {
+        unsigned int evaluated = 0;
+        auto value = [&]() {
+            evaluated++;
+            return evaluated;
+        };
+
+        Log::setLevel(LogError);
+        LOG(LogDebug, "debug", value());
+        LOG(LogInfo, "info", value());
+        REQUIRE(evaluated == 0);
+
+        Log::setLevel(LogLevel(LOG_MIN_LEVEL));
+        LOG(LogError, "error", value());
+        REQUIRE(evaluated == 1);
+    }
+}
@@ -758,7 +758,7 @@ TEST_CASE("OrderMatching", "[OrderMatchingGadget]")
     const BalanceLeaf &A_balanceLeafB = tx.witness.balanceUpdateB_A.before;
     const StorageLeaf &A_storageLeaf = tx.witness.storageUpdate_A.before;
     const OrderState orderStateA = {A_order, A_account, A_balanceLeafS, A_balanceLeafB, A_storageLeaf};
-    const FieldT expectFillS_A(fromFloat(tx.spotTrade.fillS_A.as_ulong(), Float24Encoding).to_string().c_str());
+    const FieldT expectFillS_A(fromFloat(tx.spotTrade.fillS_A.as_ulong(), Float24Encoding).toFieldElement());
 
     const Order &B_order = tx.spotTrade.orderB;
     const AccountLeaf &B_account = tx.witness.accountUpdate_B.before;
@@ -766,7 +766,7 @@ TEST_CASE("OrderMatching", "[OrderMatchingGadget]")
     const BalanceLeaf &B_balanceLeafB = tx.witness.balanceUpdateB_B.before;
     const StorageLeaf &B_storageLeaf = tx.witness.storageUpdate_B.before;
     const OrderState orderStateB = {B_order, B_account, B_balanceLeafS, B_balanceLeafB, B_storageLeaf};
-    const FieldT expectFillS_B(fromFloat(tx.spotTrade.fillS_B.as_ulong(), Float24Encoding).to_string().c_str());
+    const FieldT expectFillS_B(fromFloat(tx.spotTrade.fillS_B.as_ulong(), Float24Encoding).toFieldElement());
 
     unsigned int numStorageSlots = pow(2, NUM_BITS_STORAGE_ADDRESS);
     const FieldT A_storageID = rand() % numStorageSlots;
@@ -1595,6 +1595,29 @@ TEST_CASE("Selector", "[SelectorGadget]")
             }
         }
     }
+
+    SECTION("Listed values")
+    {
+        const std::vector<unsigned int> types = {0, 1, 6, 7, 8};
+        for (unsigned int t = 0; t < 10; t++)
+        {
+            protoboard<FieldT> pb;
+            Constants constants(pb, "constants");
+            pb_variable<FieldT> type = make_variable(pb, FieldT(t), ".type");
+
+            SelectorGadget selectorGadget(pb, constants, type, types, "selectorGadget");
+            selectorGadget.generate_r1cs_constraints();
+            selectorGadget.generate_r1cs_witness();
+
+            bool valid = std::find(types.begin(), types.end(), t) != types.end();
+            REQUIRE(pb.is_satisfied() == valid);
+            REQUIRE(selectorGadget.result().size() == types.size());
+            for (unsigned int i = 0; i < types.size(); i++)
+            {
+                REQUIRE((pb.val(selectorGadget.result()[i]) == ((types[i] == t) ? FieldT::one() : FieldT::zero())));
+            }
+        }
+    }
 }
 
 TEST_CASE("Select", "[SelectGadget]")
@@ -1706,6 +1729,171 @@ TEST_CASE("ArraySelect", "[ArraySelectGadget]")
     }
 }
 
+TEST_CASE("OneHotSelect", "[OneHotSelectGadget]")
+{
+    unsigned int numIterations = 16;
+    unsigned int n = 8;
+
+    // Values with duplicates, like transaction outputs that keep their default
+    auto selectChecked = [](unsigned int _index, const std::vector<unsigned int> &valueIndices) {
+        protoboard<FieldT> pb;
+        Constants constants(pb, "constants");
+
+        VariableT index = make_variable(pb, FieldT(_index), ".index");
+        VariableArrayT distinct = make_var_array(pb, valueIndices.size(), ".distinct");
+        std::vector<VariableT> values;
+        for (unsigned int i = 0; i < valueIndices.size(); i++)
+        {
+            pb.val(distinct[i]) = getRandomFieldElement();
+            values.push_back(distinct[valueIndices[i]]);
+        }
+
+        SelectorGadget selectorGadget(pb, constants, index, values.size(), "selectorGadget");
+        selectorGadget.generate_r1cs_constraints();
+        selectorGadget.generate_r1cs_witness();
+
+        size_t numConstraints = pb.num_constraints();
+        SelectGadget selectGadget(pb, constants, selectorGadget.result(), values, "selectGadget");
+        selectGadget.generate_r1cs_constraints();
+        selectGadget.generate_r1cs_witness();
+        size_t numSelectConstraints = pb.num_constraints() - numConstraints;
+
+        numConstraints = pb.num_constraints();
+        OneHotSelectGadget oneHotSelectGadget(pb, constants, selectorGadget.result(), values, "oneHotSelectGadget");
+        oneHotSelectGadget.generate_r1cs_constraints();
+        oneHotSelectGadget.generate_r1cs_witness();
+        size_t numOneHotConstraints = pb.num_constraints() - numConstraints;
+
+        // A constraint per distinct value other than the most common one
+        std::vector<unsigned int> counts(values.size(), 0);
+        for (unsigned int i = 0; i < values.size(); i++)
+        {
+            counts[valueIndices[i]]++;
+        }
+        size_t numDistinct = values.size() - std::count(counts.begin(), counts.end(), 0);
+        REQUIRE(numOneHotConstraints == numDistinct - 1);
+        REQUIRE(numOneHotConstraints <= numSelectConstraints);
+
+        REQUIRE(pb.is_satisfied());
+        REQUIRE((pb.val(oneHotSelectGadget.result()) == pb.val(values[_index])));
+
+        // Change the selected value
+        if (numDistinct > 1)
+        {
+            pb.val(oneHotSelectGadget.result()) += FieldT::one();
+            REQUIRE(pb.is_satisfied() == false);
+        }
+    };
+
+    SECTION("Random")
+    {
+        for (unsigned int i = 1; i < n; i++)
+        {
+            for (unsigned int j = 0; j < numIterations; j++)
+            {
+                std::vector<unsigned int> valueIndices;
+                for (unsigned int k = 0; k < i; k++)
+                {
+                    valueIndices.push_back(rand() % i);
+                }
+                selectChecked(rand() % i, valueIndices);
+            }
+        }
+    }
+
+    SECTION("All equal")
+    {
+        selectChecked(2, {1, 1, 1, 1});
+    }
+}
+
+TEST_CASE("OneHotArraySelect", "[OneHotArraySelectGadget]")
+{
+    unsigned int numIterations = 8;
+    unsigned int n = 8;
+    unsigned int numBits = TX_DATA_AVAILABILITY_SIZE * 8;
+
+    // Bit arrays with zero padding and shared bits, like transaction public data
+    auto selectArrayChecked = [numBits](unsigned int _index, unsigned int numValues) {
+        protoboard<FieldT> pb;
+        Constants constants(pb, "constants");
+
+        VariableT index = make_variable(pb, FieldT(_index), ".index");
+        VariableArrayT shared = make_var_array(pb, numBits, ".shared");
+        for (unsigned int i = 0; i < numBits; i++)
+        {
+            pb.val(shared[i]) = rand() % 2;
+        }
+        std::vector<VariableArrayT> values;
+        for (unsigned int i = 0; i < numValues; i++)
+        {
+            unsigned int length = rand() % numBits;
+            VariableArrayT value = make_var_array(pb, length, ".value");
+            for (unsigned int j = 0; j < length; j++)
+            {
+                pb.val(value[j]) = rand() % 2;
+                libsnark::generate_boolean_r1cs_constraint<ethsnarks::FieldT>(pb, value[j], ".value");
+            }
+            for (unsigned int j = length; j < numBits; j++)
+            {
+                value.emplace_back((j % 2 == 0) ? shared[j] : constants._0);
+            }
+            values.push_back(value);
+        }
+
+        SelectorGadget selectorGadget(pb, constants, index, values.size(), "selectorGadget");
+        selectorGadget.generate_r1cs_constraints();
+        selectorGadget.generate_r1cs_witness();
+
+        size_t numConstraints = pb.num_constraints();
+        ArraySelectGadget arraySelectGadget(pb, constants, selectorGadget.result(), values, "arraySelectGadget");
+        arraySelectGadget.generate_r1cs_constraints();
+        arraySelectGadget.generate_r1cs_witness();
+        size_t numSelectConstraints = pb.num_constraints() - numConstraints;
+
+        numConstraints = pb.num_constraints();
+        OneHotArraySelectGadget oneHotArraySelectGadget(
+          pb, constants, selectorGadget.result(), values, "oneHotArraySelectGadget");
+        oneHotArraySelectGadget.generate_r1cs_constraints();
+        oneHotArraySelectGadget.generate_r1cs_witness();
+        size_t numOneHotConstraints = pb.num_constraints() - numConstraints;
+
+        REQUIRE(numOneHotConstraints <= numSelectConstraints);
+
+        REQUIRE(pb.is_satisfied());
+        for (unsigned int i = 0; i < numBits; i++)
+        {
+            REQUIRE((pb.val(oneHotArraySelectGadget.result()[i]) == pb.val(values[_index][i])));
+        }
+
+        // Flip a bit of the result
+        unsigned int randomBit = rand() % numBits;
+        if (!oneHotArraySelectGadget.results[randomBit].innerProduct.isBase())
+        {
+            VariableT bit = oneHotArraySelectGadget.result()[randomBit];
+            pb.val(bit) = FieldT::one() - pb.val(bit);
+            REQUIRE(pb.is_satisfied() == false);
+        }
+    };
+
+    SECTION("Random")
+    {
+        for (unsigned int i = 1; i < n; i++)
+        {
+            for (unsigned int j = 0; j < numIterations; j++)
+            {
+                selectArrayChecked(rand() % i, i);
+            }
+        }
+    }
+
+    SECTION("Transaction public data")
+    {
+        // The select in SelectTransactionGadget
+        selectArrayChecked(3, (unsigned int)TransactionType::COUNT);
+    }
+}
+
 TEST_CASE("SignedAdd", "[SignedAddGadget]")
 {
     unsigned int maxLength = 252;
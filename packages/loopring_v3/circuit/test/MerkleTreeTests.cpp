@@ -223,3 +223,57 @@ TEST_CASE("UpdateStorage", "[UpdateStorageGadget]")
         updateStorageChecked(modifiedStorageUpdate, false);
     }
 }
+
+TEST_CASE("MerklePathUpdate", "[merkle_path_update_4]")
+{
+    const unsigned int depth = 3;
+    // Every position at every level
+    for (unsigned int address : {0u, 1u, 2u, 3u, 27u, 57u, 63u})
+    {
+        protoboard<FieldT> pb;
+        VariableArrayT addressBits = make_var_array(pb, depth * 2, "address");
+        VariableT leafBefore = make_variable(pb, "leafBefore");
+        VariableT leafAfter = make_variable(pb, "leafAfter");
+        VariableT rootBefore = make_variable(pb, "rootBefore");
+        VariableArrayT path = make_var_array(pb, depth * 3, "path");
+
+        size_t numConstraints = pb.num_constraints();
+        MerklePathCheckT pathBefore(pb, depth, addressBits, leafBefore, rootBefore, path, "pathBefore");
+        MerklePathT pathAfter(pb, depth, addressBits, leafAfter, path, "pathAfter");
+        pathBefore.generate_r1cs_constraints();
+        pathAfter.generate_r1cs_constraints();
+        size_t numSeparateConstraints = pb.num_constraints() - numConstraints;
+
+        numConstraints = pb.num_constraints();
+        merkle_path_address_4 pathAddress(pb, depth, addressBits, "pathAddress");
+        MerklePathUpdateT pathUpdate(pb, pathAddress, leafBefore, leafAfter, rootBefore, path, "pathUpdate");
+        pathAddress.generate_r1cs_constraints();
+        pathUpdate.generate_r1cs_constraints();
+        size_t numSharedConstraints = pb.num_constraints() - numConstraints;
+        // 16 selector constraints per level for both paths, 11 shared
+        REQUIRE(numSeparateConstraints - numSharedConstraints == depth * (16 - 11));
+
+        addressBits.fill_with_bits_of_field_element(pb, FieldT(address));
+        pb.val(leafBefore) = getRandomFieldElement();
+        pb.val(leafAfter) = getRandomFieldElement();
+        for (unsigned int i = 0; i < path.size(); i++)
+        {
+            pb.val(path[i]) = getRandomFieldElement();
+        }
+        pathAfter.generate_r1cs_witness();
+        pathAddress.generate_r1cs_witness();
+        pathUpdate.generate_r1cs_witness();
+        pb.val(rootBefore) = pb.val(pathUpdate.m_path_before.result());
+        pathBefore.generate_r1cs_witness();
+
+        REQUIRE(pb.is_satisfied());
+        REQUIRE((pb.val(pathUpdate.result()) == pb.val(pathAfter.result())));
+
+        // Another leaf before
+        pb.val(leafBefore) += 1;
+        pathBefore.generate_r1cs_witness();
+        pathUpdate.generate_r1cs_witness();
+        REQUIRE(!pathUpdate.is_valid());
+        REQUIRE(!pb.is_satisfied());
+    }
+}
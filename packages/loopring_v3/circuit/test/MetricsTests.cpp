@@ -0,0 +1,61 @@
+#include "../ThirdParty/catch.hpp"
+
+#include "../Utils/Metrics.h"
+
+using namespace Loopring;
+
+static bool contains(const std::string &text, const std::string &line)
+{
+    return text.find(line + "\n") != std::string::npos;
+}
+
+TEST_CASE("Metrics", "[Metrics]")
+{
+    MetricsRegistry registry;
+    Counter &done = registry.counter("jobs_total", "Jobs", "result=\"done\"");
+    Counter &failed = registry.counter("jobs_total", "Jobs", "result=\"failed\"");
+    Histogram &latency = registry.histogram("latency_seconds", "Latency", {1, 10});
+    registry.gauge("queue_length", "Queue", []() { return 3.0; });
+
+    done.inc();
+    done.inc();
+    failed.inc();
+    latency.observe(0.5);
+    latency.observe(5);
+    latency.observe(50);
+
+    std::string text = registry.render();
+    REQUIRE(contains(text, "# TYPE jobs_total counter"));
+    REQUIRE(contains(text, "jobs_total{result=\"done\"} 2"));
+    REQUIRE(contains(text, "jobs_total{result=\"failed\"} 1"));
+    REQUIRE(contains(text, "# TYPE latency_seconds histogram"));
+    REQUIRE(contains(text, "latency_seconds_bucket{le=\"1\"} 1"));
+    REQUIRE(contains(text, "latency_seconds_bucket{le=\"10\"} 2"));
+    REQUIRE(contains(text, "latency_seconds_bucket{le=\"+Inf\"} 3"));
+    REQUIRE(contains(text, "latency_seconds_sum 55.5"));
+    REQUIRE(contains(text, "latency_seconds_count 3"));
+    REQUIRE(contains(text, "queue_length 3"));
+    // A single HELP/TYPE per metric family
+    REQUIRE(text.find("# HELP jobs_total") == text.rfind("# HELP jobs_total"));
+}
+
+TEST_CASE("Metrics large values", "[Metrics]")
+{
+    MetricsRegistry registry;
+    Counter &bytes = registry.counter("bytes_total", "Bytes");
+    Histogram &size = registry.histogram("size_bytes", "Size", {0.05, 1e9});
+    registry.gauge("memory_bytes", "Memory", []() { return 68719476736.0; });
+
+    bytes.inc(123456789);
+    bytes.inc(1);
+    size.observe(4294967296.0);
+    size.observe(0.25);
+
+    // Exact values, not rounded to 6 digits in scientific notation
+    std::string text = registry.render();
+    REQUIRE(contains(text, "bytes_total 123456790"));
+    REQUIRE(contains(text, "memory_bytes 68719476736"));
+    REQUIRE(contains(text, "size_bytes_sum 4294967296.25"));
+    REQUIRE(contains(text, "size_bytes_bucket{le=\"0.05\"} 0"));
+    REQUIRE(contains(text, "size_bytes_bucket{le=\"1000000000\"} 1"));
+}
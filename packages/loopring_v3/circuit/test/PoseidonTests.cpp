@@ -0,0 +1,106 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Gadgets/MathGadgets.h"
+#include "../Utils/Poseidon.h"
+
+template <typename Gadget, typename Native> static void checkNative(unsigned int numInputs)
+{
+    protoboard<FieldT> pb;
+    VariableArrayT inputs = make_var_array(pb, numInputs, "inputs");
+    Gadget gadget(pb, inputs, "gadget");
+    gadget.generate_r1cs_constraints();
+
+    std::vector<FieldT> values;
+    for (unsigned int i = 0; i < numInputs; i++)
+    {
+        values.push_back(getRandomFieldElement());
+    }
+    inputs.fill_with_field_elements(pb, values);
+    gadget.generate_r1cs_witness();
+
+    REQUIRE(pb.is_satisfied());
+    REQUIRE((Native::hash(values) == pb.val(gadget.result())));
+}
+
+TEST_CASE("Native Poseidon", "[Poseidon]")
+{
+    SECTION("matches the gadgets")
+    {
+        checkNative<Poseidon_2, NativePoseidon_2>(2);
+        checkNative<Poseidon_4_<1>, NativePoseidon_4>(1);
+        checkNative<Poseidon_4, NativePoseidon_4>(4);
+        checkNative<Poseidon_5, NativePoseidon_5>(5);
+        checkNative<Poseidon_7, NativePoseidon_7>(7);
+        checkNative<Poseidon_11, NativePoseidon_11>(11);
+        checkNative<Poseidon_13, NativePoseidon_13>(13);
+    }
+
+    SECTION("batch")
+    {
+        // Not a multiple of the number of lanes
+        const unsigned int numHashes = 4 * NativePoseidon_4::LANES + 3;
+        std::vector<FieldT> inputs;
+        for (unsigned int i = 0; i < numHashes * 4; i++)
+        {
+            inputs.push_back(getRandomFieldElement());
+        }
+        std::vector<FieldT> outputs;
+        NativePoseidon_4::hashBatch(inputs, 4, outputs);
+        REQUIRE(outputs.size() == numHashes);
+        for (unsigned int i = 0; i < numHashes; i++)
+        {
+            std::vector<FieldT> single(inputs.begin() + i * 4, inputs.begin() + (i + 1) * 4);
+            REQUIRE((outputs[i] == NativePoseidon_4::hash(single)));
+        }
+    }
+}
+
+// Merkle tree hashes (4 inputs) of a single transaction slot.
+// Run with: dex_circuit_tests "[benchmark]"
+TEST_CASE("Poseidon witness", "[.][benchmark]")
+{
+    const unsigned int numHashes = 512;
+
+    protoboard<FieldT> pb;
+    std::vector<VariableArrayT> inputs;
+    std::vector<Poseidon_4> gadgets;
+    gadgets.reserve(numHashes);
+    std::vector<FieldT> values;
+    for (unsigned int i = 0; i < numHashes; i++)
+    {
+        inputs.push_back(make_var_array(pb, 4, "inputs"));
+        gadgets.emplace_back(pb, inputs.back(), "gadget");
+        for (unsigned int j = 0; j < 4; j++)
+        {
+            pb.val(inputs.back()[j]) = getRandomFieldElement();
+            values.push_back(pb.val(inputs.back()[j]));
+        }
+    }
+
+    BENCHMARK("Poseidon_4 gadget witness")
+    {
+        for (Poseidon_4 &gadget : gadgets)
+        {
+            gadget.generate_r1cs_witness();
+        }
+        return pb.val(gadgets.back().result());
+    };
+
+    BENCHMARK("Native Poseidon_4, one at a time")
+    {
+        FieldT result;
+        for (unsigned int i = 0; i < numHashes; i++)
+        {
+            NativePoseidon_4::hash(&values[i * 4], 4, &result, 1);
+        }
+        return result;
+    };
+
+    BENCHMARK("Native Poseidon_4, batched")
+    {
+        std::vector<FieldT> outputs;
+        NativePoseidon_4::hashBatch(values, 4, outputs);
+        return outputs.back();
+    };
+}
@@ -136,7 +136,11 @@ TEST_CASE("SignatureVerifier", "[SignatureVerifier]")
 
 TEST_CASE("CompressPublicKey", "[CompressPublicKey]")
 {
-    auto compressPublicKeyChecked = [](const FieldT &_pubKeyX, const FieldT &_pubKeyY, bool checkValid = false) {
+    auto compressPublicKeyChecked = [](
+                                      const FieldT &_pubKeyX,
+                                      const FieldT &_pubKeyY,
+                                      bool checkValid = false,
+                                      const PublicKeyRoots *roots = nullptr) {
         protoboard<FieldT> pb;
         Constants constants(pb, "constants");
 
@@ -145,7 +149,8 @@ TEST_CASE("CompressPublicKey", "[CompressPublicKey]")
         pb.val(publicKey.x) = _pubKeyX;
         pb.val(publicKey.y) = _pubKeyY;
 
-        CompressPublicKey compressPublicKey(pb, params, constants, publicKey.x, publicKey.y, "compressPublicKey");
+        CompressPublicKey compressPublicKey(
+          pb, params, constants, publicKey.x, publicKey.y, "compressPublicKey", roots);
         compressPublicKey.generate_r1cs_constraints();
         compressPublicKey.generate_r1cs_witness();
 
@@ -179,4 +184,40 @@ TEST_CASE("CompressPublicKey", "[CompressPublicKey]")
         compressPublicKeyChecked(pubKeyX_1, pubKeyY_2, false);
         compressPublicKeyChecked(pubKeyX_2, pubKeyY_1, false);
     }
+
+    SECTION("Batched roots")
+    {
+        jubjub::Params params;
+        PublicKeyRoots roots;
+        roots.resolve(params, {pubKeyY_1, FieldT::zero(), pubKeyY_2, pubKeyY_1});
+        REQUIRE(roots.size() == 3);
+        REQUIRE(roots.find(FieldT("123")) == nullptr);
+
+        compressPublicKeyChecked(pubKeyX_1, pubKeyY_1, true, &roots);
+        compressPublicKeyChecked(pubKeyX_2, pubKeyY_2, true, &roots);
+        compressPublicKeyChecked(FieldT::zero(), FieldT::zero(), true, &roots);
+        compressPublicKeyChecked(pubKeyX_2, pubKeyY_1, false, &roots);
+    }
+}
+
+TEST_CASE("batchInverse", "[FieldBatch]")
+{
+    std::vector<FieldT> values;
+    for (unsigned int i = 0; i < 17; i++)
+    {
+        values.push_back((i % 5 == 0) ? FieldT::zero() : getRandomFieldElement());
+    }
+    std::vector<FieldT> inverses = values;
+    batchInverse(inverses);
+    for (unsigned int i = 0; i < values.size(); i++)
+    {
+        if (values[i].is_zero())
+        {
+            REQUIRE(inverses[i].is_zero());
+        }
+        else
+        {
+            REQUIRE((inverses[i] == values[i].inverse()));
+        }
+    }
 }
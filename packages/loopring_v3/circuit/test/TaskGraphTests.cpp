@@ -0,0 +1,53 @@
+#include "../ThirdParty/catch.hpp"
+
+#include "../Utils/TaskGraph.h"
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace Loopring;
+
+TEST_CASE("TaskGraph", "[TaskGraph]")
+{
+    SECTION("dependencies run first")
+    {
+        TaskGraph graph;
+        std::vector<int> values(8, 0);
+        std::vector<unsigned int> leaves;
+        unsigned int root = graph.add("root", 1, [&]() { values[0] = 1; });
+        for (unsigned int i = 1; i < 7; i++)
+        {
+            leaves.push_back(graph.add("leaf", i, [&values, i]() { values[i] = values[0] + 1; }, {root}));
+        }
+        graph.add(
+          "sum",
+          1,
+          [&]() {
+              for (unsigned int i = 1; i < 7; i++)
+              {
+                  values[7] += values[i];
+              }
+          },
+          leaves);
+        graph.run();
+        REQUIRE(values[7] == 12);
+
+        double duration;
+        std::vector<unsigned int> path = graph.getCriticalPath(duration);
+        REQUIRE(path.size() == 3);
+        REQUIRE(graph.getName(path.front()) == "root");
+        REQUIRE(graph.getName(path.back()) == "sum");
+        REQUIRE(duration <= graph.getWorkTime());
+    }
+
+    SECTION("failed tasks stop their dependents")
+    {
+        TaskGraph graph;
+        std::atomic<unsigned int> numRun(0);
+        unsigned int failing = graph.add("failing", 1, [&]() { throw std::runtime_error("failed"); });
+        graph.add("independent", 1, [&]() { numRun++; });
+        graph.add("dependent", 1, [&]() { numRun += 10; }, {failing});
+        REQUIRE_THROWS_AS(graph.run(), std::runtime_error);
+        REQUIRE(numRun == 1);
+    }
+}
@@ -25,6 +25,21 @@ static const BigInt &validate(const BigInt &v)
     return v;
 }
 
+static BigInt toBigInt(ethsnarks::FieldT _value, bool sign = true)
+{
+    auto value = _value.as_bigint();
+    BigInt bi = 0;
+    for (unsigned int i = 0; i < value.num_bits(); i++)
+    {
+        bi = bi * 2 + (value.test_bit(value.num_bits() - 1 - i) ? 1 : 0);
+    }
+    if (!sign)
+    {
+        bi = -bi;
+    }
+    return bi;
+}
+
 static BigInt abs(const BigInt& num) {
     return num < 0 ? -num : num;
 }
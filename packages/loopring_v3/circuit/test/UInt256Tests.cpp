@@ -0,0 +1,53 @@
+#include "../ThirdParty/catch.hpp"
+#include "TestUtils.h"
+
+#include "../Utils/UInt256.h"
+
+TEST_CASE("UInt256", "[UInt256]")
+{
+    unsigned int numIterations = 1024;
+
+    SECTION("field element conversion")
+    {
+        for (unsigned int i = 0; i < numIterations; i++)
+        {
+            FieldT value = getRandomFieldElement();
+            UInt256 v(value);
+            REQUIRE((v.toFieldElement() == value));
+            REQUIRE(v.numBits() == value.as_bigint().num_bits());
+        }
+        REQUIRE(UInt256(FieldT::zero()).isZero());
+    }
+
+    SECTION("division")
+    {
+        for (unsigned int i = 0; i < numIterations; i++)
+        {
+            FieldT a = getRandomFieldElement(1 + rand() % 253);
+            FieldT b = getRandomFieldElement(1 + rand() % 253);
+            if (b == FieldT::zero())
+            {
+                continue;
+            }
+            UInt256 q, r;
+            UInt256::divmod(UInt256(a), UInt256(b), q, r);
+            REQUIRE((q.toFieldElement() == toFieldElement(toBigInt(a) / toBigInt(b))));
+            REQUIRE((r.toFieldElement() == toFieldElement(toBigInt(a) % toBigInt(b))));
+            REQUIRE((UInt256(a) < UInt256(b)) == (toBigInt(a) < toBigInt(b)));
+        }
+    }
+
+    SECTION("multiplication")
+    {
+        for (unsigned int i = 0; i < numIterations; i++)
+        {
+            FieldT a = getRandomFieldElement(126);
+            FieldT b = getRandomFieldElement(126);
+            UInt256 product;
+            REQUIRE(!UInt256::mulOverflow(UInt256(a), UInt256(b), product));
+            REQUIRE((product.toFieldElement() == a * b));
+        }
+        UInt256 product;
+        REQUIRE(UInt256::mulOverflow(UInt256(1) << 200, UInt256(1) << 100, product));
+    }
+}
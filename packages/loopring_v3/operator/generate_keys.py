@@ -1,6 +1,13 @@
 from create_block import *
 import subprocess
 
+# Block types 0-3 all use the universal circuit ("all" keys)
+BLOCK_TYPE_UNIVERSAL = 0
+# All transaction slots light ("light" keys)
+BLOCK_TYPE_LIGHT = 4
+# Light transaction slots with 1/8 full slots ("mixed" keys)
+BLOCK_TYPE_MIXED = 5
+
 class Struct(object): pass
 
 def generate_keys(blockType, blockSize):
@@ -24,9 +31,5 @@ if __name__ == "__main__":
     # size_arr = [4] # simple test
 
     for size in size_arr:
-        for blockType in range(4):
-            generate_keys(blockType, size, False)
-
-    for size in size_arr:
-        for blockType in [0, 3]:
-            generate_keys(blockType, size, True)
+        for blockType in [BLOCK_TYPE_UNIVERSAL, BLOCK_TYPE_LIGHT, BLOCK_TYPE_MIXED]:
+            generate_keys(blockType, size)